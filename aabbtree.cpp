@@ -0,0 +1,420 @@
+// aabbtree.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <float.h>
+#include <algorithm>
+
+#include "simd.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "particlestore.h"
+#include "aabbtree.h"
+
+// faixas por eixo na avaliacao da SAH
+static const int BINS = 16;
+
+struct AabbBin
+{
+	float _min[3];
+	float _max[3];
+	int _count;
+};
+
+static inline void Clear(float* lo, float* hi)
+{
+	for(int a = 0; a < 3; a++)
+	{
+		lo[a] = FLT_MAX;
+		hi[a] = -FLT_MAX;
+	}
+}
+
+static inline void Grow(float* lo, float* hi, const float* boxLo, const float* boxHi)
+{
+	for(int a = 0; a < 3; a++)
+	{
+		if(boxLo[a] < lo[a])
+			lo[a] = boxLo[a];
+		if(boxHi[a] > hi[a])
+			hi[a] = boxHi[a];
+	}
+}
+
+// faixa de um centro; posicoes invalidas (NaN) caem na primeira
+static inline int Bin(float value, float origin, float scale)
+{
+	float t = (value - origin) * scale;
+	if(!(t > 0.0f))
+		return 0;
+	return t < BINS - 1 ? (int)t : BINS - 1;
+}
+
+// metade da area da superficie da caixa
+static inline float Area(const float* lo, const float* hi)
+{
+	float dx = hi[0] - lo[0];
+	float dy = hi[1] - lo[1];
+	float dz = hi[2] - lo[2];
+	return dx * dy + dy * dz + dz * dx;
+}
+
+AabbTree::AabbTree()
+{
+	_threshold = 2.0f;
+	_rebuilds = 0;
+	_subtreeRebuilds = 0;
+}
+
+AabbTree::~AabbTree()
+{
+}
+
+int AabbTree::Split(ParticleStore* store, int begin, int end)
+{
+	const Vector3* position = store->_currPosition;
+	const float* radius = store->_radius;
+
+	// limites dos centros
+	float lo[3], hi[3];
+	Clear(lo, hi);
+	for(int k = begin; k < end; k++)
+	{
+		const float* c = &position[_items[k]].x;
+		Grow(lo, hi, c, c);
+	}
+
+	// plano de menor custo SAH entre as faixas dos tres eixos
+	int bestAxis = -1;
+	int bestBin = 0;
+	float bestCost = FLT_MAX;
+	for(int axis = 0; axis < 3; axis++)
+	{
+		float extent = hi[axis] - lo[axis];
+		if(extent <= 0.0f)
+			continue;
+		float scale = BINS / extent;
+
+		AabbBin bins[BINS];
+		for(int k = 0; k < BINS; k++)
+		{
+			Clear(bins[k]._min, bins[k]._max);
+			bins[k]._count = 0;
+		}
+		for(int k = begin; k < end; k++)
+		{
+			int i = _items[k];
+			const float* c = &position[i].x;
+			int bin = Bin(c[axis], lo[axis], scale);
+
+			float boxLo[3] = { c[0] - radius[i], c[1] - radius[i], c[2] - radius[i] };
+			float boxHi[3] = { c[0] + radius[i], c[1] + radius[i], c[2] + radius[i] };
+			Grow(bins[bin]._min, bins[bin]._max, boxLo, boxHi);
+			bins[bin]._count++;
+		}
+
+		// area e contagem a direita de cada plano
+		float rightArea[BINS];
+		int rightCount[BINS];
+		float boxLo[3], boxHi[3];
+		Clear(boxLo, boxHi);
+		int count = 0;
+		for(int k = BINS - 1; k > 0; k--)
+		{
+			Grow(boxLo, boxHi, bins[k]._min, bins[k]._max);
+			count += bins[k]._count;
+			rightArea[k] = count > 0 ? Area(boxLo, boxHi) : 0.0f;
+			rightCount[k] = count;
+		}
+
+		Clear(boxLo, boxHi);
+		count = 0;
+		for(int k = 1; k < BINS; k++)
+		{
+			Grow(boxLo, boxHi, bins[k-1]._min, bins[k-1]._max);
+			count += bins[k-1]._count;
+			if(count == 0 || rightCount[k] == 0)
+				continue;
+
+			float cost = count * Area(boxLo, boxHi) + rightCount[k] * rightArea[k];
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = k;
+			}
+		}
+	}
+
+	// centros coincidentes: divide ao meio
+	if(bestAxis < 0)
+		return begin + (end - begin) / 2;
+
+	float origin = lo[bestAxis];
+	float scale = BINS / (hi[bestAxis] - lo[bestAxis]);
+	std::vector<int>::iterator middle = std::partition(_items.begin() + begin, _items.begin() + end, [&](int i)
+	{
+		return Bin((&position[i].x)[bestAxis], origin, scale) < bestBin;
+	});
+	return (int)(middle - _items.begin());
+}
+
+void AabbTree::Build(ParticleStore* store, int first, int begin, int end)
+{
+	// cada tarefa (no, inicio, fim) constroi uma subarvore; com uma particula
+	// por folha a subarvore de n particulas ocupa 2n - 1 nos
+	_tasks.clear();
+	_tasks.push_back(first);
+	_tasks.push_back(begin);
+	_tasks.push_back(end);
+
+	while(!_tasks.empty())
+	{
+		int last = (int)_tasks.size() - 3;
+		int node = _tasks[last];
+		int from = _tasks[last+1];
+		int to = _tasks[last+2];
+		_tasks.resize(last);
+
+		int count = to - from;
+		if(count == 1)
+		{
+			int id = store->_id[_items[from]];
+			_nodes[node]._particle = id;
+			_nodes[node]._skip = node + 1;
+			_leafOf[id] = node;
+			continue;
+		}
+
+		_nodes[node]._particle = -1;
+		_nodes[node]._skip = node + 2 * count - 1;
+
+		int split = Split(store, from, to);
+		_tasks.push_back(node + 2 * (split - from));
+		_tasks.push_back(split);
+		_tasks.push_back(to);
+		_tasks.push_back(node + 1);
+		_tasks.push_back(from);
+		_tasks.push_back(split);
+	}
+
+	int last = first + 2 * (end - begin) - 1;
+	Refit(store, first, last);
+	for(int n = first; n < last; n++)
+	{
+		_buildCost[n] = _cost[n];
+	}
+}
+
+void AabbTree::Refit(ParticleStore* store, int first, int last)
+{
+	const Vector3* position = store->_currPosition;
+	const float* radius = store->_radius;
+
+	// os filhos vem depois do pai: de tras para frente
+	for(int n = last - 1; n >= first; n--)
+	{
+		AabbNode& node = _nodes[n];
+		if(node._particle >= 0)
+		{
+			int i = store->_slot[node._particle];
+			const float* c = &position[i].x;
+			for(int a = 0; a < 3; a++)
+			{
+				node._min[a] = c[a] - radius[i];
+				node._max[a] = c[a] + radius[i];
+			}
+			_cost[n] = 0.0f;
+			continue;
+		}
+
+		const AabbNode& left = _nodes[n+1];
+		const AabbNode& right = _nodes[left._skip];
+		for(int a = 0; a < 3; a++)
+		{
+			node._min[a] = left._min[a] < right._min[a] ? left._min[a] : right._min[a];
+			node._max[a] = left._max[a] > right._max[a] ? left._max[a] : right._max[a];
+		}
+		_cost[n] = Area(node._min, node._max) + _cost[n+1] + _cost[left._skip];
+	}
+}
+
+void AabbTree::Rebuild(ParticleStore* store)
+{
+	int count = store->_count;
+	int nodes = count > 0 ? 2 * count - 1 : 0;
+
+	_leafOf.assign(store->_slot.size(), -1);
+	_nodes.resize(nodes);
+	_cost.resize(nodes);
+	_buildCost.resize(nodes);
+	_items.resize(count);
+	for(int i = 0; i < count; i++)
+	{
+		_items[i] = i;
+	}
+
+	if(count > 0)
+		Build(store, 0, 0, count);
+	_rebuilds++;
+}
+
+int AabbTree::FindPairs(ParticleStore* store, Scheduler* scheduler, int chunk, std::vector<int>& pairs)
+{
+	int count = store->_count;
+	pairs.clear();
+
+	{
+		PROFILE_ZONE("AabbTree::Refit", 0);
+
+		// o conjunto de particulas mudou: reconstrucao completa
+		int ids = (int)store->_slot.size();
+		if((int)_leafOf.size() < ids)
+			_leafOf.resize(ids, -1);
+		bool changed = 2 * count - 1 != (int)_nodes.size();
+		for(int i = 0; i < count && !changed; i++)
+		{
+			int id = store->_id[i];
+			int leaf = _leafOf[id];
+			changed = leaf < 0 || _nodes[leaf]._particle != id;
+		}
+
+		if(changed)
+			Rebuild(store);
+		else
+		{
+			int nodes = (int)_nodes.size();
+			Refit(store, 0, nodes);
+
+			// reconstroi as subarvores mais altas que se degradaram
+			int n = 0;
+			while(n < nodes)
+			{
+				const AabbNode& node = _nodes[n];
+				if(node._particle >= 0 || _cost[n] <= _threshold * _buildCost[n])
+				{
+					n++;
+					continue;
+				}
+				if(n == 0)
+				{
+					Rebuild(store);
+					break;
+				}
+
+				int skip = node._skip;
+				int items = 0;
+				for(int m = n; m < skip; m++)
+				{
+					if(_nodes[m]._particle >= 0)
+						_items[items++] = store->_slot[_nodes[m]._particle];
+				}
+				Build(store, n, 0, items);
+				_subtreeRebuilds++;
+				n = skip;
+			}
+		}
+	}
+
+	if(count < 2)
+		return 0;
+
+	int chunks = (count + chunk - 1) / chunk;
+	if((int)_chunkPairs.size() < chunks)
+		_chunkPairs.resize(chunks);
+
+	scheduler->ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("AabbTree::FindPairs", thread);
+		std::vector<int>& chunkPairs = _chunkPairs[begin / chunk];
+		chunkPairs.clear();
+		FindPairs(store, begin, end, chunkPairs);
+	});
+
+	// cada par e emitido pela particula cuja folha vem antes, o que depende
+	// da historia da arvore; a ordem canonica (por a, depois por b, com
+	// a < b) faz os contatos serem resolvidos na mesma ordem em qualquer
+	// arvore, por exemplo depois de restaurar um checkpoint
+	{
+		PROFILE_ZONE("AabbTree::SortPairs", 0);
+
+		_sortedPairs.clear();
+		for(int c = 0; c < chunks; c++)
+		{
+			const std::vector<int>& chunkPairs = _chunkPairs[c];
+			for(int k = 0; k < (int)chunkPairs.size(); k += 2)
+				_sortedPairs.push_back(((unsigned long long)chunkPairs[k] << 32) | (unsigned int)chunkPairs[k+1]);
+		}
+		std::sort(_sortedPairs.begin(), _sortedPairs.end());
+
+		pairs.resize(2 * _sortedPairs.size());
+		for(int k = 0; k < (int)_sortedPairs.size(); k++)
+		{
+			pairs[2*k] = (int)(_sortedPairs[k] >> 32);
+			pairs[2*k+1] = (int)(_sortedPairs[k] & 0xffffffffu);
+		}
+	}
+
+	return (int)pairs.size() / 2;
+}
+
+void AabbTree::FindPairs(ParticleStore* store, int begin, int end, std::vector<int>& pairs)
+{
+	const Particle::ParticleType* type = store->_particleType;
+	const AabbNode* nodes = &_nodes[0];
+	int count = (int)_nodes.size();
+
+	for(int a = begin; a < end; a++)
+	{
+		int leaf = _leafOf[store->_id[a]];
+		const AabbNode& box = nodes[leaf];
+		bool sleeping = type[a] == Particle::SLEEPING;
+
+#ifdef SIMD_SSE
+		// a quarta faixa (salto, particula) e descartada na mascara
+		__m128 boxMin = _mm_loadu_ps(box._min);
+		__m128 boxMax = _mm_loadu_ps(box._max);
+#endif
+
+		int n = 0;
+		while(n < count)
+		{
+			const AabbNode& node = nodes[n];
+
+			// subarvores antes da folha so tem pares ja emitidos por elas
+			if(node._skip <= leaf)
+			{
+				n = node._skip;
+				continue;
+			}
+
+#ifdef SIMD_SSE
+			__m128 overlap = _mm_and_ps(
+				_mm_cmple_ps(boxMin, _mm_loadu_ps(node._max)),
+				_mm_cmple_ps(_mm_loadu_ps(node._min), boxMax));
+			bool hit = (_mm_movemask_ps(overlap) & 7) == 7;
+#else
+			bool hit = box._min[0] <= node._max[0] && node._min[0] <= box._max[0] &&
+				box._min[1] <= node._max[1] && node._min[1] <= box._max[1] &&
+				box._min[2] <= node._max[2] && node._min[2] <= box._max[2];
+#endif
+			if(!hit)
+			{
+				n = node._skip;
+				continue;
+			}
+
+			if(node._particle >= 0 && n > leaf)
+			{
+				int b = store->_slot[node._particle];
+				if(!sleeping || type[b] != Particle::SLEEPING)
+				{
+					pairs.push_back(a < b ? a : b);
+					pairs.push_back(a < b ? b : a);
+				}
+			}
+			n++;
+		}
+	}
+}
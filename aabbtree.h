@@ -0,0 +1,86 @@
+// aabbtree.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include <vector>
+
+class Scheduler;
+class ParticleStore;
+
+// No da arvore: caixa envolvente e, nos campos livres, o salto e a
+// particula. Os nos ficam em pre-ordem: o filho esquerdo de um no interno e o
+// no seguinte e _skip e o primeiro no depois da subarvore, de modo que a
+// busca percorre o vetor sem pilha. Cada metade ocupa 16 bytes e e lida com
+// uma unica carga SSE.
+struct AabbNode
+{
+	float _min[3];
+	int _skip;
+	float _max[3];
+	// identificador da particula nas folhas; -1 nos nos internos
+	int _particle;
+};
+
+// Hierarquia de caixas envolventes (BVH) para a fase larga da colisao entre
+// particulas. Ao contrario da grade, nao depende de um tamanho de celula e
+// por isso se comporta bem quando os raios variam muito (uma esfera grande
+// sob um pano de particulas pequenas). Cada folha guarda uma particula; a
+// arvore e construida de cima para baixo com a heuristica de area de
+// superficie (SAH) avaliada em faixas nos tres eixos.
+// A cada passo as caixas sao reajustadas de baixo para cima e o custo SAH de
+// cada subarvore e comparado com o custo que ela tinha ao ser construida; a
+// subarvore mais alta cujo custo cresceu mais que _threshold vezes e
+// reconstruida no mesmo trecho do vetor, com as mesmas particulas. Quando o
+// conjunto de particulas muda (emissao, remocao) a arvore e reconstruida
+// inteira. As folhas guardam o identificador da particula (ver
+// ParticleStore), e nao a posicao, e sobrevivem a reordenacoes.
+// Cada particula percorre a arvore com a sua caixa e emite os pares com as
+// folhas que vem depois da sua, de modo que cada par aparece uma vez, exceto
+// pares de duas particulas adormecidas. A busca e dividida em blocos de
+// particulas e os pares sao entregues ordenados pelos indices (a < b), de
+// modo que o resultado nao depende do numero de threads nem da forma da
+// arvore, que varia com as reconstrucoes parciais.
+class AabbTree
+{
+public:
+	AabbTree();
+	~AabbTree();
+
+	// crescimento do custo SAH de uma subarvore que dispara a sua
+	// reconstrucao
+	float _threshold;
+
+	// estatisticas desde o inicio: reconstrucoes completas e de subarvores
+	int _rebuilds;
+	int _subtreeRebuilds;
+
+	std::vector<AabbNode> _nodes;
+	std::vector<std::vector<int> > _chunkPairs;
+
+	// Preenche pairs com os pares candidatos (2 indices por par); retorna o
+	// numero de pares
+	int FindPairs(ParticleStore* store, Scheduler* scheduler, int chunk, std::vector<int>& pairs);
+
+private:
+	// custo SAH de cada no: atual e na construcao
+	std::vector<float> _cost;
+	std::vector<float> _buildCost;
+	// no folha de cada identificador (-1 fora da arvore)
+	std::vector<int> _leafOf;
+	std::vector<int> _items;
+	std::vector<int> _tasks;
+	// pares como (a << 32) | b, para a ordenacao
+	std::vector<unsigned long long> _sortedPairs;
+
+	void Build(ParticleStore* store, int first, int begin, int end);
+	int Split(ParticleStore* store, int begin, int end);
+	void Refit(ParticleStore* store, int first, int last);
+	void Rebuild(ParticleStore* store);
+	void FindPairs(ParticleStore* store, int begin, int end, std::vector<int>& pairs);
+};
+
+#endif
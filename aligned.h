@@ -0,0 +1,55 @@
+// aligned.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef ALIGNED_H
+#define ALIGNED_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+// Alinhamento de uma linha de cache, suficiente para SSE/AVX
+#define ALIGNMENT 64
+
+inline void* AlignedAlloc(size_t size)
+{
+	if(size == 0)
+		size = ALIGNMENT;
+#ifdef _MSC_VER
+	return _aligned_malloc(size, ALIGNMENT);
+#else
+	void* p = 0;
+	if(posix_memalign(&p, ALIGNMENT, size) != 0)
+		return 0;
+	return p;
+#endif
+}
+
+inline void AlignedFree(void* p)
+{
+#ifdef _MSC_VER
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+// Realoca um vetor alinhado preservando os primeiros count elementos
+template <class T>
+inline void AlignedResize(T*& data, int count, int capacity)
+{
+	T* p = (T*)AlignedAlloc(capacity * sizeof(T));
+	if(data)
+	{
+		memcpy(p, data, count * sizeof(T));
+		AlignedFree(data);
+	}
+	data = p;
+}
+
+#endif
@@ -0,0 +1,103 @@
+// blockmatrix.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <string.h>
+#include <algorithm>
+
+#include "blockmatrix.h"
+
+BlockMatrix::BlockMatrix()
+{
+	_rowCount = 0;
+}
+
+void BlockMatrix::BuildPattern(int rowCount, const int* rowA, const int* rowB, int pairs)
+{
+	_rowCount = rowCount;
+
+	// contagem por linha, com o bloco diagonal e as repeticoes
+	std::vector<int> start(rowCount + 1, 0);
+	for(int i = 0; i < rowCount; i++)
+		start[i + 1]++;
+	for(int i = 0; i < pairs; i++)
+	{
+		start[rowA[i] + 1]++;
+		start[rowB[i] + 1]++;
+	}
+	for(int i = 0; i < rowCount; i++)
+		start[i + 1] += start[i];
+
+	std::vector<int> fill(start.begin(), start.end() - 1);
+	std::vector<int> column(start[rowCount]);
+	for(int i = 0; i < rowCount; i++)
+		column[fill[i]++] = i;
+	for(int i = 0; i < pairs; i++)
+	{
+		column[fill[rowA[i]]++] = rowB[i];
+		column[fill[rowB[i]]++] = rowA[i];
+	}
+
+	// ordena cada linha e remove as repeticoes
+	_rowStart.resize(rowCount + 1);
+	_column.clear();
+	_diagonal.resize(rowCount);
+	for(int i = 0; i < rowCount; i++)
+	{
+		_rowStart[i] = (int)_column.size();
+
+		std::sort(column.begin() + start[i], column.begin() + start[i + 1]);
+		for(int k = start[i]; k < start[i + 1]; k++)
+		{
+			if(k > start[i] && column[k] == column[k - 1])
+				continue;
+			if(column[k] == i)
+				_diagonal[i] = (int)_column.size();
+			_column.push_back(column[k]);
+		}
+	}
+	_rowStart[rowCount] = (int)_column.size();
+
+	_blocks.assign(_column.size() * 9, 0.0f);
+}
+
+int BlockMatrix::Find(int row, int column) const
+{
+	const int* first = _column.empty() ? 0 : &_column[0] + _rowStart[row];
+	const int* last = _column.empty() ? 0 : &_column[0] + _rowStart[row + 1];
+	const int* found = std::lower_bound(first, last, column);
+	if(found == last || *found != column)
+		return -1;
+	return (int)(found - &_column[0]);
+}
+
+void BlockMatrix::Clear(int begin, int end)
+{
+	if(begin >= end)
+		return;
+
+	int first = _rowStart[begin];
+	int last = _rowStart[end];
+	if(last > first)
+		memset(&_blocks[first * 9], 0, (last - first) * 9 * sizeof(float));
+}
+
+void BlockMatrix::Multiply(const Vector3* x, Vector3* y, int begin, int end) const
+{
+	for(int i = begin; i < end; i++)
+	{
+		float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+		for(int k = _rowStart[i]; k < _rowStart[i + 1]; k++)
+		{
+			const float* m = &_blocks[k * 9];
+			const Vector3& v = x[_column[k]];
+			sx += m[0] * v.x + m[1] * v.y + m[2] * v.z;
+			sy += m[3] * v.x + m[4] * v.y + m[5] * v.z;
+			sz += m[6] * v.x + m[7] * v.y + m[8] * v.z;
+		}
+		y[i].x = sx;
+		y[i].y = sy;
+		y[i].z = sz;
+	}
+}
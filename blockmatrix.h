@@ -0,0 +1,44 @@
+// blockmatrix.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef BLOCKMATRIX_H
+#define BLOCKMATRIX_H
+
+#include <vector>
+
+#include "vector.h"
+
+// Matriz esparsa de blocos 3x3 em linhas comprimidas (BSR). O padrao de
+// esparsidade (blocos nao nulos de cada linha, em ordem crescente de coluna)
+// e montado uma vez e reaproveitado; a cada passo apenas os valores dos
+// blocos sao reescritos. Cada bloco ocupa 9 floats em ordem de linha.
+class BlockMatrix
+{
+public:
+	BlockMatrix();
+
+	int _rowCount;
+	// blocos da linha i: [_rowStart[i], _rowStart[i + 1])
+	std::vector<int> _rowStart;
+	std::vector<int> _column;
+	// indice do bloco diagonal de cada linha
+	std::vector<int> _diagonal;
+	std::vector<float> _blocks;
+
+	// Monta o padrao com todos os blocos diagonais e os blocos (a, b) e (b, a)
+	// de cada par; pares repetidos geram um unico bloco
+	void BuildPattern(int rowCount, const int* rowA, const int* rowB, int pairs);
+
+	// Indice do bloco (row, column), ou -1 se nao pertence ao padrao
+	int Find(int row, int column) const;
+
+	// Zera os blocos das linhas [begin, end)
+	void Clear(int begin, int end);
+
+	// y = A x para as linhas [begin, end)
+	void Multiply(const Vector3* x, Vector3* y, int begin, int end) const;
+};
+
+#endif
@@ -0,0 +1,69 @@
+// bruteforce.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+
+#include "profiler.h"
+#include "scheduler.h"
+#include "particlestore.h"
+#include "bruteforce.h"
+
+BruteForce::BruteForce()
+{
+}
+
+BruteForce::~BruteForce()
+{
+}
+
+int BruteForce::FindPairs(ParticleStore* store, Scheduler* scheduler, int chunk, std::vector<int>& pairs)
+{
+	int count = store->_count;
+
+	pairs.clear();
+	if(count < 2)
+		return 0;
+
+	int chunks = (count + chunk - 1) / chunk;
+	if((int)_chunkPairs.size() < chunks)
+		_chunkPairs.resize(chunks);
+
+	scheduler->ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("BruteForce::FindPairs", thread);
+		const Vector3* position = store->_currPosition;
+		const float* radius = store->_radius;
+		const Particle::ParticleType* type = store->_particleType;
+		std::vector<int>& chunkPairs = _chunkPairs[begin / chunk];
+		chunkPairs.clear();
+
+		for(int i = begin; i < end; i++)
+		{
+			bool sleeping = type[i] == Particle::SLEEPING;
+			for(int j = i + 1; j < count; j++)
+			{
+				if(sleeping && type[j] == Particle::SLEEPING)
+					continue;
+
+				// caixas envolventes disjuntas em algum eixo
+				float h = radius[i] + radius[j];
+				if(fabsf(position[i].x - position[j].x) > h ||
+					fabsf(position[i].y - position[j].y) > h ||
+					fabsf(position[i].z - position[j].z) > h)
+					continue;
+
+				chunkPairs.push_back(i);
+				chunkPairs.push_back(j);
+			}
+		}
+	});
+
+	for(int c = 0; c < chunks; c++)
+	{
+		pairs.insert(pairs.end(), _chunkPairs[c].begin(), _chunkPairs[c].end());
+	}
+
+	return (int)pairs.size() / 2;
+}
@@ -0,0 +1,33 @@
+// bruteforce.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef BRUTEFORCE_H
+#define BRUTEFORCE_H
+
+#include <vector>
+
+class Scheduler;
+class ParticleStore;
+
+// Fase larga por forca bruta: todos os pares (i, j) com i < j sao testados
+// e sao candidatos os pares cujas caixas envolventes se sobrepoem, exceto
+// pares de duas particulas adormecidas. Serve de referencia para as demais
+// fases largas e e competitiva apenas com poucas particulas. Os pares de
+// cada bloco de particulas i sao concatenados na ordem dos blocos, de modo
+// que o resultado nao depende do numero de threads.
+class BruteForce
+{
+public:
+	BruteForce();
+	~BruteForce();
+
+	std::vector<std::vector<int> > _chunkPairs;
+
+	// Preenche pairs com os pares candidatos (2 indices por par); retorna o
+	// numero de pares
+	int FindPairs(ParticleStore* store, Scheduler* scheduler, int chunk, std::vector<int>& pairs);
+};
+
+#endif
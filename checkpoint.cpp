@@ -0,0 +1,779 @@
+// checkpoint.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gravity.h"
+#include "medium.h"
+#include "simulation.h"
+#include "checkpoint.h"
+
+static const char s_magic[4] = { 'S', 'F', 'C', 'P' };
+
+//
+// Escrita
+//
+
+static void Write(std::vector<char>& data, const void* value, size_t bytes)
+{
+	size_t offset = data.size();
+	data.resize(offset + bytes);
+	if(bytes > 0)
+		memcpy(&data[offset], value, bytes);
+}
+
+template<class T>
+static void Write(std::vector<char>& data, T value)
+{
+	Write(data, &value, sizeof(T));
+}
+
+//
+// Leitura com verificacao de limites
+//
+
+struct Reader
+{
+	const char* _data;
+	size_t _size;
+	size_t _offset;
+	bool _failed;
+
+	Reader(const char* data, size_t size)
+	{
+		_data = data;
+		_size = size;
+		_offset = 0;
+		_failed = false;
+	}
+
+	const char* Take(size_t bytes)
+	{
+		if(_failed || bytes > _size - _offset)
+		{
+			_failed = true;
+			return 0;
+		}
+		const char* p = _data + _offset;
+		_offset += bytes;
+		return p;
+	}
+
+	// vetor de count elementos de elementSize bytes, sem copia
+	const char* TakeArray(int count, size_t elementSize)
+	{
+		if(count < 0 || (size_t)count > (_size - _offset) / elementSize)
+		{
+			_failed = true;
+			return 0;
+		}
+		return Take(count * elementSize);
+	}
+
+	template<class T>
+	T Read()
+	{
+		T value;
+		const char* p = Take(sizeof(T));
+		if(p != 0)
+			memcpy(&value, p, sizeof(T));
+		else
+			memset((void*)&value, 0, sizeof(T));
+		return value;
+	}
+};
+
+// verifica se todos os indices do vetor estao em [0, count)
+static bool ValidIndices(const char* indices, int size, int count)
+{
+	for(int i = 0; i < size; i++)
+	{
+		int index;
+		memcpy(&index, indices + i * sizeof(int), sizeof(int));
+		if(index < 0 || index >= count)
+			return false;
+	}
+	return true;
+}
+
+// falso para NaN e infinitos
+static bool Finite(float value)
+{
+	return value - value == 0.0f;
+}
+
+struct PlaneRecord
+{
+	float size;
+	Vector3 normal;
+	Vector3 position;
+	float red, green, blue;
+};
+
+struct ColliderRecord
+{
+	Vector3 origin;
+	float spacing;
+	int nx, ny, nz;
+	float red, green, blue;
+};
+
+struct MeshRecord
+{
+	float thickness;
+	float red, green, blue;
+	// bytes do bloco da hierarquia que segue o registro
+	int size;
+};
+
+struct ForceGeneratorRecord
+{
+	int type;
+	Vector3 acceleration;
+	float dragCoefficient;
+};
+
+struct ParticleGeneratorRecord
+{
+	int enabled;
+	int max;
+	float mass;
+	float radius;
+	float rate;
+	float lifetime;
+	int burst;
+	Vector3 position;
+	Vector3 extent;
+	Vector3 velocity;
+	Vector3 spread;
+	unsigned int seed;
+	unsigned int stream;
+	int generated;
+	double time;
+	float accumulator;
+	int head;
+	int live;
+};
+
+struct IslandRecord
+{
+	int enabled;
+	float sleepVelocity;
+	float sleepDistance;
+	float sleepTime;
+	int islandCount;
+	// particulas com contagem de repouso e com ilha (as inseridas depois do
+	// ultimo Update ainda nao tem)
+	int rest;
+	int islands;
+};
+
+struct MortonRecord
+{
+	int enabled;
+	int checkInterval;
+	float threshold;
+	int steps;
+	float baseline;
+	float disorder;
+	int reorders;
+};
+
+void Checkpoint::Save(Simulation* simulation, std::vector<char>& data)
+{
+	ParticleStore& store = simulation->_store;
+	SpringTable& springs = simulation->_springs;
+	ConstraintTable& constraints = simulation->_constraints;
+
+	data.clear();
+
+	// cabecalho
+	Write(data, s_magic, sizeof(s_magic));
+	Write<int>(data, CHECKPOINT_VERSION);
+
+	// parametros
+	Write<float>(data, simulation->_dissipative);
+	Write<int>(data, simulation->_chunkSize);
+
+	// particulas
+	int n = store._count;
+	Write<int>(data, n);
+	Write(data, store._currPosition, n * sizeof(Vector3));
+	Write(data, store._prevPosition, n * sizeof(Vector3));
+	Write(data, store._currVelocity, n * sizeof(Vector3));
+	Write(data, store._resultantForce, n * sizeof(Vector3));
+	Write(data, store._mass, n * sizeof(float));
+	Write(data, store._inverseMass, n * sizeof(float));
+	Write(data, store._radius, n * sizeof(float));
+	Write(data, store._particleType, n * sizeof(Particle::ParticleType));
+	Write(data, store._color, 3 * n * sizeof(float));
+	Write(data, store._id, n * sizeof(int));
+	int ids = (int)store._generation.size();
+	int freeIds = (int)store._freeIds.size();
+	Write<int>(data, ids);
+	Write(data, ids > 0 ? &store._generation[0] : 0, ids * sizeof(int));
+	Write<int>(data, freeIds);
+	Write(data, freeIds > 0 ? &store._freeIds[0] : 0, freeIds * sizeof(int));
+
+	// molas
+	int s = springs._count;
+	Write<int>(data, s);
+	Write(data, springs._particleA, s * sizeof(int));
+	Write(data, springs._particleB, s * sizeof(int));
+	Write(data, springs._restLength, s * sizeof(float));
+	Write(data, springs._stiffness, s * sizeof(float));
+	Write(data, springs._damping, s * sizeof(float));
+
+	// restricoes; as cores sao refeitas na restauracao
+	int c = constraints._count;
+	Write<int>(data, c);
+	Write(data, constraints._particleA, c * sizeof(int));
+	Write(data, constraints._particleB, c * sizeof(int));
+	Write(data, constraints._length, c * sizeof(float));
+
+	// planos
+	Write<int>(data, (int)simulation->_planes.size());
+	for(int i = 0; i < (int)simulation->_planes.size(); i++)
+	{
+		Plane* plane = simulation->_planes[i];
+		PlaneRecord record;
+		record.size = plane->_size;
+		record.normal = plane->_normal;
+		record.position = plane->_position;
+		record.red = plane->_red;
+		record.green = plane->_green;
+		record.blue = plane->_blue;
+		Write(data, record);
+	}
+
+	// obstaculos SDF: grade seguida das amostras
+	Write<int>(data, (int)simulation->_colliders.size());
+	for(int i = 0; i < (int)simulation->_colliders.size(); i++)
+	{
+		SdfCollider* collider = simulation->_colliders[i];
+		ColliderRecord record;
+		record.origin = collider->_origin;
+		record.spacing = collider->_spacing;
+		record.nx = collider->_nx;
+		record.ny = collider->_ny;
+		record.nz = collider->_nz;
+		record.red = collider->_red;
+		record.green = collider->_green;
+		record.blue = collider->_blue;
+		Write(data, record);
+		Write(data, collider->_distance.empty() ? 0 : &collider->_distance[0], collider->_distance.size() * sizeof(float));
+	}
+
+	// obstaculos de malha: o bloco da hierarquia, como no arquivo .bvh
+	Write<int>(data, (int)simulation->_meshes.size());
+	for(int i = 0; i < (int)simulation->_meshes.size(); i++)
+	{
+		MeshCollider* mesh = simulation->_meshes[i];
+		MeshRecord record;
+		record.thickness = mesh->_thickness;
+		record.red = mesh->_red;
+		record.green = mesh->_green;
+		record.blue = mesh->_blue;
+		record.size = (int)mesh->Size();
+		Write(data, record);
+		Write(data, mesh->Data(), mesh->Size());
+	}
+
+	// geradores de forca
+	Write<int>(data, (int)simulation->_forceGenerators.size());
+	for(int i = 0; i < (int)simulation->_forceGenerators.size(); i++)
+	{
+		ForceGenerator* generator = simulation->_forceGenerators[i];
+		ForceGeneratorRecord record;
+		record.type = generator->_forceGeneratorType;
+		record.acceleration = Vector3(0.0f, 0.0f, 0.0f);
+		record.dragCoefficient = 0.0f;
+		if(generator->_forceGeneratorType == ForceGenerator::GRAVITY)
+			record.acceleration = ((Gravity*)generator)->_acceleration;
+		else if(generator->_forceGeneratorType == ForceGenerator::MEDIUM)
+			record.dragCoefficient = ((Medium*)generator)->_dragCoefficient;
+		Write(data, record);
+	}
+
+	// integrador
+	Integrator* integrator = simulation->_integrator;
+	Write<int>(data, integrator->_integratorType);
+	Write<float>(data, integrator->_fixedTimeStep);
+	Write<float>(data, integrator->_integratorType == Integrator::VERLET ? static_cast<Verlet*>(integrator)->_drag : 0.0f);
+
+	// gerador de particulas
+	ParticleGenerator* particleGenerator = simulation->_particleGenerator;
+	Write<int>(data, particleGenerator != 0);
+	if(particleGenerator != 0)
+	{
+		ParticleGeneratorRecord record;
+		memset((void*)&record, 0, sizeof(record));
+		record.enabled = particleGenerator->_enabled;
+		record.max = particleGenerator->_max;
+		record.mass = particleGenerator->_mass;
+		record.radius = particleGenerator->_radius;
+		record.rate = particleGenerator->_rate;
+		record.lifetime = particleGenerator->_lifetime;
+		record.burst = particleGenerator->_burst;
+		record.position = particleGenerator->_position;
+		record.extent = particleGenerator->_extent;
+		record.velocity = particleGenerator->_velocity;
+		record.spread = particleGenerator->_spread;
+		record.seed = particleGenerator->_random._seed;
+		record.stream = particleGenerator->_random._stream;
+		record.generated = particleGenerator->_generated;
+		record.time = particleGenerator->_time;
+		record.accumulator = particleGenerator->_accumulator;
+		record.head = particleGenerator->_head;
+		record.live = particleGenerator->_live;
+		Write(data, record);
+
+		// anel das particulas vivas
+		int max = particleGenerator->_max;
+		Write(data, max > 0 ? &particleGenerator->_ring[0] : 0, max * sizeof(ParticleHandle));
+		Write(data, max > 0 ? &particleGenerator->_birth[0] : 0, max * sizeof(double));
+	}
+
+	// ilhas: contagem de repouso e ilha de cada particula no ultimo Update
+	IslandManager& islands = simulation->_islands;
+	IslandRecord islandRecord;
+	islandRecord.enabled = islands._enabled;
+	islandRecord.sleepVelocity = islands._sleepVelocity;
+	islandRecord.sleepDistance = islands._sleepDistance;
+	islandRecord.sleepTime = islands._sleepTime;
+	islandRecord.islandCount = islands._islandCount;
+	islandRecord.rest = (int)islands._restTime.size();
+	islandRecord.islands = (int)islands._island.size();
+	Write(data, islandRecord);
+	Write(data, islandRecord.rest > 0 ? &islands._restTime[0] : 0, islandRecord.rest * sizeof(float));
+	Write(data, islandRecord.rest > 0 ? &islands._restPosition[0] : 0, islandRecord.rest * sizeof(Vector3));
+	Write(data, islandRecord.islands > 0 ? &islands._island[0] : 0, islandRecord.islands * sizeof(int));
+
+	// reordenacao: contagem de passos ate a proxima medida e desordem de
+	// referencia
+	MortonOrder& morton = simulation->_morton;
+	MortonRecord mortonRecord;
+	mortonRecord.enabled = morton._enabled;
+	mortonRecord.checkInterval = morton._checkInterval;
+	mortonRecord.threshold = morton._threshold;
+	mortonRecord.steps = morton._steps;
+	mortonRecord.baseline = morton._baseline;
+	mortonRecord.disorder = morton._disorder;
+	mortonRecord.reorders = morton._reorders;
+	Write(data, mortonRecord);
+}
+
+bool Checkpoint::Restore(Simulation* simulation, const char* data, size_t size)
+{
+	Reader reader(data, size);
+
+	//
+	// Validacao: todos os dados sao lidos e conferidos antes de alterar a
+	// simulacao. Os vetores grandes sao apenas localizados em data.
+	//
+
+	const char* magic = reader.Take(sizeof(s_magic));
+	if(magic == 0 || memcmp(magic, s_magic, sizeof(s_magic)) != 0)
+		return false;
+	if(reader.Read<int>() != CHECKPOINT_VERSION)
+		return false;
+
+	float dissipative = reader.Read<float>();
+	int chunkSize = reader.Read<int>();
+
+	int n = reader.Read<int>();
+	const char* currPosition = reader.TakeArray(n, sizeof(Vector3));
+	const char* prevPosition = reader.TakeArray(n, sizeof(Vector3));
+	const char* currVelocity = reader.TakeArray(n, sizeof(Vector3));
+	const char* resultantForce = reader.TakeArray(n, sizeof(Vector3));
+	const char* mass = reader.TakeArray(n, sizeof(float));
+	const char* inverseMass = reader.TakeArray(n, sizeof(float));
+	const char* radius = reader.TakeArray(n, sizeof(float));
+	const char* particleType = reader.TakeArray(n, sizeof(Particle::ParticleType));
+	const char* color = reader.TakeArray(3 * n, sizeof(float));
+	const char* id = reader.TakeArray(n, sizeof(int));
+	int ids = reader.Read<int>();
+	const char* generation = reader.TakeArray(ids, sizeof(int));
+	int freeIds = reader.Read<int>();
+	const char* freeId = reader.TakeArray(freeIds, sizeof(int));
+
+	int s = reader.Read<int>();
+	const char* springA = reader.TakeArray(s, sizeof(int));
+	const char* springB = reader.TakeArray(s, sizeof(int));
+	const char* restLength = reader.TakeArray(s, sizeof(float));
+	const char* stiffness = reader.TakeArray(s, sizeof(float));
+	const char* damping = reader.TakeArray(s, sizeof(float));
+
+	int c = reader.Read<int>();
+	const char* constraintA = reader.TakeArray(c, sizeof(int));
+	const char* constraintB = reader.TakeArray(c, sizeof(int));
+	const char* length = reader.TakeArray(c, sizeof(float));
+
+	int planeCount = reader.Read<int>();
+	const char* planes = reader.TakeArray(planeCount, sizeof(PlaneRecord));
+
+	int colliderCount = reader.Read<int>();
+	if(colliderCount < 0)
+		return false;
+	std::vector<ColliderRecord> colliders;
+	std::vector<const char*> colliderSamples;
+	for(int i = 0; i < colliderCount && !reader._failed; i++)
+	{
+		ColliderRecord record = reader.Read<ColliderRecord>();
+		if(record.nx < 2 || record.ny < 2 || record.nz < 2 || !(record.spacing > 0.0f) ||
+			(long long)record.nx * record.ny * record.nz > 0x7fffffff)
+			return false;
+		colliders.push_back(record);
+		colliderSamples.push_back(reader.TakeArray(record.nx * record.ny * record.nz, sizeof(float)));
+	}
+
+	int meshCount = reader.Read<int>();
+	if(meshCount < 0)
+		return false;
+	std::vector<MeshRecord> meshes;
+	std::vector<const char*> meshData;
+	for(int i = 0; i < meshCount && !reader._failed; i++)
+	{
+		MeshRecord record = reader.Read<MeshRecord>();
+		const char* block = reader.TakeArray(record.size, 1);
+		if(record.size < 0 || (block && !MeshCollider::Validate(block, record.size)))
+			return false;
+		meshes.push_back(record);
+		meshData.push_back(block);
+	}
+
+	int generatorCount = reader.Read<int>();
+	const char* generators = reader.TakeArray(generatorCount, sizeof(ForceGeneratorRecord));
+
+	int integratorType = reader.Read<int>();
+	float fixedTimeStep = reader.Read<float>();
+	float drag = reader.Read<float>();
+
+	int hasParticleGenerator = reader.Read<int>();
+	ParticleGeneratorRecord generatorRecord;
+	memset((void*)&generatorRecord, 0, sizeof(generatorRecord));
+	const char* ring = 0;
+	const char* birth = 0;
+	if(hasParticleGenerator)
+	{
+		generatorRecord = reader.Read<ParticleGeneratorRecord>();
+		ring = reader.TakeArray(generatorRecord.max, sizeof(ParticleHandle));
+		birth = reader.TakeArray(generatorRecord.max, sizeof(double));
+	}
+
+	IslandRecord islandRecord = reader.Read<IslandRecord>();
+	const char* restTime = reader.TakeArray(islandRecord.rest, sizeof(float));
+	const char* restPosition = reader.TakeArray(islandRecord.rest, sizeof(Vector3));
+	const char* island = reader.TakeArray(islandRecord.islands, sizeof(int));
+
+	MortonRecord mortonRecord = reader.Read<MortonRecord>();
+
+	if(reader._failed || reader._offset != size)
+		return false;
+
+	if(!ValidIndices(springA, s, n) || !ValidIndices(springB, s, n) ||
+		!ValidIndices(constraintA, c, n) || !ValidIndices(constraintB, c, n))
+		return false;
+
+	// identificadores das particulas e livres formam uma permutacao de
+	// [0, ids)
+	if(n + freeIds != ids || !ValidIndices(id, n, ids) || !ValidIndices(freeId, freeIds, ids))
+		return false;
+	std::vector<char> seen(ids, 0);
+	for(int i = 0; i < ids; i++)
+	{
+		int index;
+		memcpy(&index, i < n ? id + i * sizeof(int) : freeId + (i - n) * sizeof(int), sizeof(int));
+		if(seen[index])
+			return false;
+		seen[index] = 1;
+	}
+
+	for(int i = 0; i < n; i++)
+	{
+		Particle::ParticleType type;
+		memcpy(&type, particleType + i * sizeof(type), sizeof(type));
+		if(type != Particle::PASSIVE && type != Particle::ACTIVE && type != Particle::SLEEPING)
+			return false;
+	}
+
+	for(int i = 0; i < generatorCount; i++)
+	{
+		ForceGeneratorRecord record;
+		memcpy(&record, generators + i * sizeof(record), sizeof(record));
+		if(record.type != ForceGenerator::GRAVITY && record.type != ForceGenerator::MEDIUM)
+			return false;
+	}
+
+	if(integratorType < Integrator::NONE || integratorType > Integrator::IMPLICIT_EULER)
+		return false;
+
+	// parametros que dividem ou multiplicam todo o estado a cada passo
+	if(chunkSize <= 0 || !Finite(fixedTimeStep) || !(fixedTimeStep > 0.0f) || !Finite(dissipative))
+		return false;
+
+	if(generatorRecord.live < 0 || generatorRecord.live > generatorRecord.max ||
+		generatorRecord.head < 0 || generatorRecord.head >= (generatorRecord.max > 0 ? generatorRecord.max : 1))
+		return false;
+
+	if(islandRecord.rest > n || islandRecord.islands > n ||
+		islandRecord.islandCount < 0 || islandRecord.islandCount > islandRecord.islands)
+		return false;
+	for(int i = 0; i < islandRecord.islands; i++)
+	{
+		int index;
+		memcpy(&index, island + i * sizeof(int), sizeof(int));
+		if(index < -1 || index >= islandRecord.islandCount)
+			return false;
+	}
+
+	if(mortonRecord.steps < 0 || !Finite(mortonRecord.baseline) || !Finite(mortonRecord.threshold))
+		return false;
+
+	//
+	// Aplicacao
+	//
+
+	simulation->_dissipative = dissipative;
+	simulation->_chunkSize = chunkSize;
+
+	ParticleStore& store = simulation->_store;
+	store.Resize(n);
+	memcpy(store._currPosition, currPosition, n * sizeof(Vector3));
+	memcpy(store._prevPosition, prevPosition, n * sizeof(Vector3));
+	memcpy(store._currVelocity, currVelocity, n * sizeof(Vector3));
+	memcpy(store._resultantForce, resultantForce, n * sizeof(Vector3));
+	memcpy(store._mass, mass, n * sizeof(float));
+	memcpy(store._inverseMass, inverseMass, n * sizeof(float));
+	memcpy(store._radius, radius, n * sizeof(float));
+	memcpy(store._particleType, particleType, n * sizeof(Particle::ParticleType));
+	memcpy(store._color, color, 3 * n * sizeof(float));
+	memcpy(store._id, id, n * sizeof(int));
+	store._generation.resize(ids);
+	store._freeIds.resize(freeIds);
+	if(ids > 0)
+		memcpy(&store._generation[0], generation, ids * sizeof(int));
+	if(freeIds > 0)
+		memcpy(&store._freeIds[0], freeId, freeIds * sizeof(int));
+	store.RebuildSlots();
+
+	SpringTable& springs = simulation->_springs;
+	springs.Resize(s);
+	memcpy(springs._particleA, springA, s * sizeof(int));
+	memcpy(springs._particleB, springB, s * sizeof(int));
+	memcpy(springs._restLength, restLength, s * sizeof(float));
+	memcpy(springs._stiffness, stiffness, s * sizeof(float));
+	memcpy(springs._damping, damping, s * sizeof(float));
+
+	// a coloracao gulosa e refeita na mesma ordem de insercao, entao as
+	// cores e os lotes ficam iguais aos da simulacao gravada
+	ConstraintTable& constraints = simulation->_constraints;
+	constraints.Clear();
+	constraints.Reserve(c);
+	for(int i = 0; i < c; i++)
+	{
+		int a, b;
+		float l;
+		memcpy(&a, constraintA + i * sizeof(int), sizeof(int));
+		memcpy(&b, constraintB + i * sizeof(int), sizeof(int));
+		memcpy(&l, length + i * sizeof(float), sizeof(float));
+		constraints.Add(l, a, b);
+	}
+
+	for(int i = 0; i < (int)simulation->_planes.size(); i++)
+	{
+		delete simulation->_planes[i];
+	}
+	simulation->_planes.clear();
+	for(int i = 0; i < planeCount; i++)
+	{
+		PlaneRecord record;
+		memcpy(&record, planes + i * sizeof(record), sizeof(record));
+
+		Plane* plane = new Plane();
+		plane->Initialize(record.size, record.normal, record.position, record.red, record.green, record.blue);
+		simulation->AddPlane(plane);
+	}
+
+	for(int i = 0; i < (int)simulation->_colliders.size(); i++)
+	{
+		delete simulation->_colliders[i];
+	}
+	simulation->_colliders.clear();
+	for(int i = 0; i < colliderCount; i++)
+	{
+		const ColliderRecord& record = colliders[i];
+
+		SdfCollider* collider = new SdfCollider();
+		collider->Initialize(record.origin, record.spacing, record.nx, record.ny, record.nz, record.red, record.green, record.blue);
+		collider->SetSamples((const float*)colliderSamples[i]);
+		simulation->AddCollider(collider);
+	}
+
+	for(int i = 0; i < (int)simulation->_meshes.size(); i++)
+	{
+		delete simulation->_meshes[i];
+	}
+	simulation->_meshes.clear();
+	for(int i = 0; i < meshCount; i++)
+	{
+		MeshCollider* mesh = new MeshCollider();
+		mesh->_thickness = meshes[i].thickness;
+		mesh->_red = meshes[i].red;
+		mesh->_green = meshes[i].green;
+		mesh->_blue = meshes[i].blue;
+		mesh->SetData(meshData[i], meshes[i].size);
+		simulation->AddMesh(mesh);
+	}
+
+	for(int i = 0; i < (int)simulation->_forceGenerators.size(); i++)
+	{
+		delete simulation->_forceGenerators[i];
+	}
+	simulation->_forceGenerators.clear();
+	for(int i = 0; i < generatorCount; i++)
+	{
+		ForceGeneratorRecord record;
+		memcpy(&record, generators + i * sizeof(record), sizeof(record));
+
+		if(record.type == ForceGenerator::GRAVITY)
+			simulation->AddForceGenerator((ForceGenerator*)new Gravity(record.acceleration));
+		else
+			simulation->AddForceGenerator((ForceGenerator*)new Medium(record.dragCoefficient));
+	}
+
+	Integrator* integrator;
+	if(integratorType == Integrator::EULER)
+	{
+		integrator = new Euler();
+	}
+	else if(integratorType == Integrator::VERLET)
+	{
+		Verlet* verlet = new Verlet();
+		verlet->_drag = drag;
+		integrator = verlet;
+	}
+	else if(integratorType == Integrator::SYMPLECTIC_EULER)
+	{
+		integrator = new SymplecticEuler();
+	}
+	else if(integratorType == Integrator::LEAPFROG)
+	{
+		integrator = new Leapfrog();
+	}
+	else if(integratorType == Integrator::RUNGE_KUTTA4)
+	{
+		integrator = new RungeKutta4();
+	}
+	else if(integratorType == Integrator::IMPLICIT_EULER)
+	{
+		integrator = new ImplicitEuler();
+	}
+	else
+	{
+		integrator = new Integrator();
+	}
+	integrator->_fixedTimeStep = fixedTimeStep;
+	delete simulation->_integrator;
+	simulation->_integrator = integrator;
+
+	// o gerador restaurado retoma o anel das particulas que ja estao no
+	// store; a rajada inicial nao e repetida
+	delete simulation->_particleGenerator;
+	simulation->_particleGenerator = 0;
+	if(hasParticleGenerator)
+	{
+		ParticleGenerator* particleGenerator = new ParticleGenerator();
+		particleGenerator->Resize(generatorRecord.max);
+		particleGenerator->_enabled = generatorRecord.enabled != 0;
+		particleGenerator->_mass = generatorRecord.mass;
+		particleGenerator->_radius = generatorRecord.radius;
+		particleGenerator->_rate = generatorRecord.rate;
+		particleGenerator->_lifetime = generatorRecord.lifetime;
+		particleGenerator->_burst = generatorRecord.burst;
+		particleGenerator->_position = generatorRecord.position;
+		particleGenerator->_extent = generatorRecord.extent;
+		particleGenerator->_velocity = generatorRecord.velocity;
+		particleGenerator->_spread = generatorRecord.spread;
+		particleGenerator->_random = Random(generatorRecord.seed, generatorRecord.stream);
+		particleGenerator->_generated = generatorRecord.generated;
+		particleGenerator->_time = generatorRecord.time;
+		particleGenerator->_accumulator = generatorRecord.accumulator;
+		particleGenerator->_head = generatorRecord.head;
+		particleGenerator->_live = generatorRecord.live;
+		if(generatorRecord.max > 0)
+		{
+			memcpy(&particleGenerator->_ring[0], ring, generatorRecord.max * sizeof(ParticleHandle));
+			memcpy(&particleGenerator->_birth[0], birth, generatorRecord.max * sizeof(double));
+		}
+		simulation->_particleGenerator = particleGenerator;
+	}
+
+	IslandManager& islands = simulation->_islands;
+	islands._enabled = islandRecord.enabled != 0;
+	islands._sleepVelocity = islandRecord.sleepVelocity;
+	islands._sleepDistance = islandRecord.sleepDistance;
+	islands._sleepTime = islandRecord.sleepTime;
+	islands._islandCount = islandRecord.islandCount;
+	islands._restTime.resize(islandRecord.rest);
+	islands._restPosition.resize(islandRecord.rest);
+	islands._island.resize(islandRecord.islands);
+	if(islandRecord.rest > 0)
+	{
+		memcpy(&islands._restTime[0], restTime, islandRecord.rest * sizeof(float));
+		memcpy(&islands._restPosition[0], restPosition, islandRecord.rest * sizeof(Vector3));
+	}
+	if(islandRecord.islands > 0)
+		memcpy(&islands._island[0], island, islandRecord.islands * sizeof(int));
+	islands.BuildMembers();
+
+	MortonOrder& morton = simulation->_morton;
+	morton._enabled = mortonRecord.enabled != 0;
+	morton._checkInterval = mortonRecord.checkInterval;
+	morton._threshold = mortonRecord.threshold;
+	morton._steps = mortonRecord.steps;
+	morton._baseline = mortonRecord.baseline;
+	morton._disorder = mortonRecord.disorder;
+	morton._reorders = mortonRecord.reorders;
+
+	return true;
+}
+
+bool Checkpoint::SaveFile(Simulation* simulation, const char* path)
+{
+	std::vector<char> data;
+	Save(simulation, data);
+
+	FILE* file = fopen(path, "wb");
+	if(file == 0)
+		return false;
+
+	bool ok = fwrite(&data[0], 1, data.size(), file) == data.size();
+	ok = fclose(file) == 0 && ok;
+	return ok;
+}
+
+bool Checkpoint::RestoreFile(Simulation* simulation, const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if(file == 0)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if(size <= 0)
+	{
+		fclose(file);
+		return false;
+	}
+
+	std::vector<char> data(size);
+	bool ok = fread(&data[0], 1, data.size(), file) == data.size();
+	fclose(file);
+
+	return ok && Restore(simulation, &data[0], data.size());
+}
@@ -0,0 +1,50 @@
+// checkpoint.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <vector>
+
+class Simulation;
+
+// Versao atual do formato; Restore recusa versoes diferentes
+#define CHECKPOINT_VERSION 9
+
+// Gravacao e restauracao do estado completo de uma simulacao em um formato
+// binario versionado. O formato e composto de secoes em sequencia:
+// cabecalho, parametros da simulacao, particulas, molas, restricoes, planos,
+// obstaculos SDF (grade e amostras), obstaculos de malha (o bloco da
+// hierarquia, ver MeshCollider), geradores de forca (com etiqueta de
+// tipo), integrador, gerador de particulas, estado das ilhas (contagem de
+// repouso e ilha de cada particula, ver IslandManager) e da reordenacao
+// (passos ate a proxima medida e desordem de referencia, ver MortonOrder).
+// Os atributos das particulas e das molas sao copiados como vetores
+// inteiros, sem conversao por elemento; os valores ficam na ordem de bytes
+// da maquina (little-endian nas plataformas suportadas).
+// Molas e restricoes referenciam particulas pelo indice no ParticleStore,
+// entao nao ha ponteiros a reconstruir. O slot map das particulas (ver
+// ParticleStore) tambem e gravado: identificadores, geracoes e
+// identificadores livres, de modo que handles obtidos antes da gravacao
+// continuam validos depois da restauracao.
+class Checkpoint
+{
+public:
+	// Serializa a simulacao em data. O conteudo anterior e descartado mas a
+	// capacidade e reaproveitada, de modo que gravacoes periodicas no mesmo
+	// buffer nao alocam memoria.
+	static void Save(Simulation* simulation, std::vector<char>& data);
+
+	// Substitui o estado da simulacao pelo estado serializado. Planos,
+	// obstaculos, geradores e integrador atuais sao destruidos. Os dados sao validados
+	// por completo antes de qualquer alteracao; retorna false se estiverem
+	// corrompidos ou forem de outra versao, e nesse caso a simulacao nao muda.
+	static bool Restore(Simulation* simulation, const char* data, size_t size);
+
+	static bool SaveFile(Simulation* simulation, const char* path);
+	static bool RestoreFile(Simulation* simulation, const char* path);
+};
+
+#endif
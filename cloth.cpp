@@ -5,14 +5,25 @@
 
 #include "graphics.h"
 
+#include "particlestore.h"
 #include "cloth.h"
 
 Cloth::Cloth()
 {
+	_store = 0;
+	_firstParticle = 0;
+	_particles = 0;
 }
 
 Cloth::~Cloth()
 {
+	ReleaseParticles();
+}
+
+void Cloth::ReleaseParticles()
+{
+	delete[] _particles;
+	_particles = 0;
 }
 
 void Cloth::Initialize(
@@ -26,6 +37,7 @@ void Cloth::Initialize(
 	_dimV = nV;
 	_mass = mass/(_dimU*_dimV);
 	_radius = radius;
+	ReleaseParticles();
 	_particles = new Particle[nU*nV];
 	_particleType = type;
 
@@ -60,18 +72,39 @@ void Cloth::Update()
 {
 }
 
-void Cloth::Draw()
+// Traduz os vertices dos quadrilateros de identificador para posicao,
+// descartando os que tem particulas removidas; retorna o novo numero de
+// indices
+static int MapQuads(unsigned int* quads, int count, const int* slot)
 {
-	float* coord = new float[96];
-	for(int i = 0; i < _dimU*_dimV; i++)
+	int mapped = 0;
+	for(int i = 0; i < count; i += 4)
 	{
-		coord[i*3+0] = _particles[i]._currPosition.x; 
-		coord[i*3+1] = _particles[i]._currPosition.y; 
-		coord[i*3+2] = _particles[i]._currPosition.z;
+		int a = slot[quads[i+0]];
+		int b = slot[quads[i+1]];
+		int c = slot[quads[i+2]];
+		int d = slot[quads[i+3]];
+		if(a < 0 || b < 0 || c < 0 || d < 0)
+			continue;
+
+		quads[mapped+0] = a;
+		quads[mapped+1] = b;
+		quads[mapped+2] = c;
+		quads[mapped+3] = d;
+		mapped += 4;
 	}
+	return mapped;
+}
 
-	unsigned int* quads1 = new unsigned int[48]; 
-	unsigned int* quads2 = new unsigned int[48]; 
+void Cloth::Draw()
+{
+	// os vertices sao indices no armazenamento do sistema, traduzidos pela
+	// tabela de identificadores (as particulas podem ter sido reordenadas)
+	float* coord = &_store->_currPosition[0].x;
+	const int* slot = &_store->_slot[_firstParticle];
+
+	unsigned int* quads1 = new unsigned int[_faces]; 
+	unsigned int* quads2 = new unsigned int[_faces]; 
 	
 	int index = 0;
 	int textureIndex1 = 0;
@@ -100,7 +133,12 @@ void Cloth::Draw()
 		}
 		index++;
 	} 
+	textureIndex1 = MapQuads(quads1, textureIndex1, slot);
+	textureIndex2 = MapQuads(quads2, textureIndex2, slot);
 
 	Graphics::DrawQuads(textureIndex1, quads1, coord, _red, _green, _blue);
 	Graphics::DrawQuads(textureIndex2, quads2, coord, 1.0f - _red, 1.0f - _green, 1.0f - _blue);
+
+	delete[] quads1;
+	delete[] quads2;
 }
\ No newline at end of file
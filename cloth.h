@@ -9,6 +9,8 @@
 #include "vector.h"
 #include "particle.h"
 
+class ParticleStore;
+
 class Cloth
 {
 public:
@@ -20,7 +22,12 @@ public:
 	int _dimV;
 	int _faces;
 	float _radius;
+	// estado inicial das particulas, montado por Initialize e copiado para o
+	// ParticleStore por Simulation::AddCloth, que o libera; depois disso
+	// as particulas sao lidas do store pelo intervalo de identificadores
 	Particle* _particles;
+	ParticleStore* _store;
+	int _firstParticle;
 	float _red, _green, _blue;
 	Particle::ParticleType _particleType;
 
@@ -30,6 +37,7 @@ public:
 		Vector3 p, Vector3 pU, Vector3 pV,		
 		float r, float g, float b,
 		Particle::ParticleType type);
+	void ReleaseParticles();
 	void Update();
 	void Draw();
 };
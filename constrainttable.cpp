@@ -0,0 +1,264 @@
+// constrainttable.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "simd.h"
+#include "aligned.h"
+#include "particlestore.h"
+#include "constrainttable.h"
+
+ConstraintTable::ConstraintTable()
+{
+	_count = 0;
+	_capacity = 0;
+	_colorCount = 0;
+
+	_particleA = 0;
+	_particleB = 0;
+	_length = 0;
+	_color = 0;
+
+	_batchesValid = false;
+}
+
+ConstraintTable::~ConstraintTable()
+{
+	AlignedFree(_particleA);
+	AlignedFree(_particleB);
+	AlignedFree(_length);
+	AlignedFree(_color);
+}
+
+void ConstraintTable::Reserve(int capacity)
+{
+	if(capacity <= _capacity)
+		return;
+
+	AlignedResize(_particleA, _count, capacity);
+	AlignedResize(_particleB, _count, capacity);
+	AlignedResize(_length, _count, capacity);
+	AlignedResize(_color, _count, capacity);
+
+	_capacity = capacity;
+}
+
+void ConstraintTable::Clear()
+{
+	_count = 0;
+	_colorCount = 0;
+	_particleColors.clear();
+	_batchesValid = false;
+}
+
+int ConstraintTable::Add(float length, int particleA, int particleB)
+{
+	if(_count == _capacity)
+		Reserve(_capacity < 64 ? 64 : 2 * _capacity);
+
+	int particles = (particleA > particleB ? particleA : particleB) + 1;
+	if((int)_particleColors.size() < particles)
+		_particleColors.resize(particles, 0);
+
+	// menor cor livre nas duas particulas
+	unsigned long long used = _particleColors[particleA] | _particleColors[particleB];
+	int color = 0;
+	while(color < CONSTRAINT_COLORS && (used & (1ULL << color)) != 0)
+		color++;
+
+	if(color < CONSTRAINT_COLORS)
+	{
+		_particleColors[particleA] |= 1ULL << color;
+		_particleColors[particleB] |= 1ULL << color;
+		if(color + 1 > _colorCount)
+			_colorCount = color + 1;
+	}
+
+	int i = _count;
+	_particleA[i] = particleA;
+	_particleB[i] = particleB;
+	_length[i] = length;
+	_color[i] = color;
+	_count++;
+
+	_batchesValid = false;
+
+	return i;
+}
+
+void ConstraintTable::Remap(const int* newIndex, int particleCount)
+{
+	for(int i = 0; i < _count; i++)
+	{
+		_particleA[i] = newIndex[_particleA[i]];
+		_particleB[i] = newIndex[_particleB[i]];
+	}
+
+	// cores ja usadas por particula, usadas pelas proximas insercoes
+	std::vector<unsigned long long> colors(_particleColors);
+	_particleColors.assign(particleCount, 0);
+	// newIndex so cobre as particulas atuais
+	int colored = (int)colors.size() < particleCount ? (int)colors.size() : particleCount;
+	for(int p = 0; p < colored; p++)
+		_particleColors[newIndex[p]] = colors[p];
+
+	_batchesValid = false;
+}
+
+void ConstraintTable::RemoveParticle(int particle, int moved)
+{
+	int count = 0;
+	for(int i = 0; i < _count; i++)
+	{
+		int a = _particleA[i];
+		int b = _particleB[i];
+		if(a == particle || b == particle)
+			continue;
+
+		_particleA[count] = a == moved ? particle : a;
+		_particleB[count] = b == moved ? particle : b;
+		_length[count] = _length[i];
+		_color[count] = _color[i];
+		count++;
+	}
+	_count = count;
+
+	// a particula movida leva suas cores; a removida nao tem mais restricoes
+	if(particle < (int)_particleColors.size())
+		_particleColors[particle] = 0;
+	if(moved >= 0 && moved < (int)_particleColors.size())
+	{
+		if(particle < (int)_particleColors.size())
+			_particleColors[particle] = _particleColors[moved];
+		_particleColors[moved] = 0;
+	}
+
+	// a ultima posicao (moved, ou a propria particula) deixa de existir
+	int last = moved >= 0 ? moved : particle;
+	if(last < (int)_particleColors.size())
+		_particleColors.resize(last);
+
+	_batchesValid = false;
+}
+
+void ConstraintTable::BuildBatches()
+{
+	if(_batchesValid)
+		return;
+
+	// ordenacao por contagem mantendo a ordem de insercao dentro de cada cor
+	_batchStart.assign(_colorCount + 2, 0);
+	for(int i = 0; i < _count; i++)
+	{
+		int batch = _color[i] < CONSTRAINT_COLORS ? _color[i] : _colorCount;
+		_batchStart[batch + 1]++;
+	}
+	for(int c = 0; c <= _colorCount; c++)
+	{
+		_batchStart[c + 1] += _batchStart[c];
+	}
+
+	_batchA.resize(_count);
+	_batchB.resize(_count);
+	_batchLength.resize(_count);
+
+	std::vector<int> next(_batchStart.begin(), _batchStart.end() - 1);
+	for(int i = 0; i < _count; i++)
+	{
+		int batch = _color[i] < CONSTRAINT_COLORS ? _color[i] : _colorCount;
+		int k = next[batch]++;
+		_batchA[k] = _particleA[i];
+		_batchB[k] = _particleB[i];
+		_batchLength[k] = _length[i];
+	}
+
+	_batchesValid = true;
+}
+
+void ConstraintTable::SatisfyScalar(ParticleStore* store, int begin, int end)
+{
+	Vector3* position = store->_currPosition;
+
+	for(int i = begin; i < end; i++)
+	{
+		int a = _batchA[i];
+		int b = _batchB[i];
+
+		Vector3 direction = position[b];
+		direction -= position[a];
+
+		float length = direction.Length();
+		if(length == 0.0f)
+			continue;
+		direction *= 0.5f * (length - _batchLength[i]) / length;
+
+		position[a] += direction;
+		position[b] -= direction;
+	}
+}
+
+void ConstraintTable::SatisfyUncolored(ParticleStore* store)
+{
+	SatisfyScalar(store, _batchStart[_colorCount], _batchStart[_colorCount + 1]);
+}
+
+void ConstraintTable::Satisfy(ParticleStore* store, int begin, int end)
+{
+	int i = begin;
+
+#ifdef SIMD_SSE
+	Vector3* position = store->_currPosition;
+
+	SIMD_ALIGN(16) float dx[4], dy[4], dz[4];
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	// as restricoes de um lote nao compartilham particulas, entao as 4
+	// restricoes de cada iteracao podem ser resolvidas juntas
+	for(; i + 4 <= end; i += 4)
+	{
+		for(int k = 0; k < 4; k++)
+		{
+			const Vector3& pa = position[_batchA[i+k]];
+			const Vector3& pb = position[_batchB[i+k]];
+			dx[k] = pb.x - pa.x;
+			dy[k] = pb.y - pa.y;
+			dz[k] = pb.z - pa.z;
+		}
+
+		__m128 x = _mm_load_ps(dx);
+		__m128 y = _mm_load_ps(dy);
+		__m128 z = _mm_load_ps(dz);
+
+		__m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 valid = _mm_cmpneq_ps(length2, zero);
+		__m128 length = _mm_sqrt_ps(length2);
+		__m128 safe = _mm_or_ps(length, _mm_andnot_ps(valid, one));
+
+		// deslocamento de metade do erro para cada extremo
+		__m128 scale = _mm_div_ps(
+			_mm_mul_ps(half, _mm_sub_ps(length, _mm_loadu_ps(&_batchLength[i]))), safe);
+		scale = _mm_and_ps(valid, scale);
+
+		_mm_store_ps(dx, _mm_mul_ps(x, scale));
+		_mm_store_ps(dy, _mm_mul_ps(y, scale));
+		_mm_store_ps(dz, _mm_mul_ps(z, scale));
+
+		for(int k = 0; k < 4; k++)
+		{
+			Vector3& pa = position[_batchA[i+k]];
+			Vector3& pb = position[_batchB[i+k]];
+			pa.x += dx[k];
+			pa.y += dy[k];
+			pa.z += dz[k];
+			pb.x -= dx[k];
+			pb.y -= dy[k];
+			pb.z -= dz[k];
+		}
+	}
+#endif
+
+	SatisfyScalar(store, i, end);
+}
@@ -0,0 +1,69 @@
+// constrainttable.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef CONSTRAINTTABLE_H
+#define CONSTRAINTTABLE_H
+
+#include <vector>
+
+class ParticleStore;
+
+// Numero de cores disponiveis para a coloracao das restricoes. Restricoes
+// que nao encontram cor livre vao para um lote final resolvido em serie.
+#define CONSTRAINT_COLORS 64
+
+// Tabela de restricoes de distancia entre pares de particulas.
+// Cada restricao recebe, ao ser adicionada, a menor cor ainda nao usada por
+// outra restricao que compartilhe uma de suas particulas (coloracao gulosa).
+// Restricoes da mesma cor sao independentes: cada lote de cor pode ser
+// resolvido em paralelo e com SSE, e os lotes sao percorridos em sequencia,
+// mantendo o carater Gauss-Seidel da projecao.
+class ConstraintTable
+{
+public:
+	ConstraintTable();
+	~ConstraintTable();
+
+	int _count;
+	int _capacity;
+
+	int* _particleA;
+	int* _particleB;
+	float* _length;
+	int* _color;
+
+	int _colorCount;
+	std::vector<unsigned long long> _particleColors;
+
+	// restricoes reagrupadas por cor; o lote c e [_batchStart[c], _batchStart[c+1])
+	// e o ultimo lote (indice _colorCount) contem as restricoes sem cor
+	std::vector<int> _batchStart;
+	std::vector<int> _batchA;
+	std::vector<int> _batchB;
+	std::vector<float> _batchLength;
+
+	void Reserve(int capacity);
+	void Clear();
+	int Add(float length, int particleA, int particleB);
+	// Troca o indice de cada extremo p por newIndex[p]; as restricoes e suas
+	// cores mantem a ordem
+	void Remap(const int* newIndex, int particleCount);
+	// Acompanha ParticleStore::Remove como SpringTable::RemoveParticle; as
+	// cores restantes continuam validas
+	void RemoveParticle(int particle, int moved);
+	void BuildBatches();
+	void Satisfy(ParticleStore* store, int begin, int end);
+	void SatisfyUncolored(ParticleStore* store);
+
+private:
+	bool _batchesValid;
+
+	void SatisfyScalar(ParticleStore* store, int begin, int end);
+
+	ConstraintTable(const ConstraintTable&);
+	ConstraintTable& operator= (const ConstraintTable&);
+};
+
+#endif
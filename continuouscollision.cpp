@@ -0,0 +1,327 @@
+// continuouscollision.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <algorithm>
+
+#include "profiler.h"
+#include "simulation.h"
+#include "continuouscollision.h"
+
+// sem contato no passo
+static const float NO_CONTACT = 2.0f;
+// os contatos sao procurados a uma distancia um pouco maior que a soma dos
+// raios, para que os testes discretos seguintes nao vejam as particulas ainda
+// encostadas e reflitam a velocidade de novo
+static const float SEPARATION = 1.001f;
+
+ContinuousCollision::ContinuousCollision()
+{
+	_enabled = false;
+	_maxCells = 512;
+
+	_fastCount = 0;
+	_impacts = 0;
+}
+
+// Fracao do passo em que esferas de raios somados h, que vao de a0 a a1 e de
+// b0 a b1, se tocam; NO_CONTACT se nao se tocam, se ja se tocavam no inicio
+// ou se estao se afastando
+static float SweptTime(const Vector3& a0, const Vector3& a1, const Vector3& b0, const Vector3& b1, float h)
+{
+	Vector3 p = a0;
+	p -= b0;
+	// (a1 - a0) - (b1 - b0): trocar a por b so troca o sinal de p e v
+	Vector3 v = a1;
+	v -= a0;
+	Vector3 w = b1;
+	w -= b0;
+	v -= w;
+
+	h *= SEPARATION;
+	float c = p.SqrLength() - h * h;
+	float b = Dot(p, v);
+	if(c <= 0.0f || b >= 0.0f)
+		return NO_CONTACT;
+
+	float a = v.SqrLength();
+	float disc = b * b - a * c;
+	if(disc < 0.0f)
+		return NO_CONTACT;
+
+	float t = (-b - sqrtf(disc)) / a;
+	return t <= 1.0f ? t : NO_CONTACT;
+}
+
+// Guarda o contato (t, other) se ele vem antes do atual; empates ficam com o
+// menor indice, para que o resultado nao dependa da ordem da busca
+static inline void Keep(float& time, int& other, float t, int candidate)
+{
+	if(t < time || (t == time && candidate < other))
+	{
+		time = t;
+		other = candidate;
+	}
+}
+
+void ContinuousCollision::Begin(ParticleStore* store)
+{
+	if(!_enabled)
+		return;
+
+	_start.assign(store->_currPosition, store->_currPosition + store->_count);
+}
+
+void ContinuousCollision::FindFast(ParticleStore* store)
+{
+	int count = store->_count;
+	Vector3* position = store->_currPosition;
+	float* radius = store->_radius;
+	Particle::ParticleType* type = store->_particleType;
+
+	_fast.clear();
+	for(int i = 0; i < count; i++)
+	{
+		if(type[i] != Particle::ACTIVE)
+			continue;
+
+		Vector3 displacement = position[i];
+		displacement -= _start[i];
+		if(displacement.SqrLength() > radius[i] * radius[i])
+			_fast.push_back(i);
+	}
+}
+
+void ContinuousCollision::FindContacts(Simulation* simulation)
+{
+	ParticleStore* store = &simulation->_store;
+	std::vector<Plane*>& planes = simulation->_planes;
+	int count = store->_count;
+	int fastCount = (int)_fast.size();
+
+	_fastOf.assign(count, -1);
+	for(int k = 0; k < fastCount; k++)
+	{
+		_fastOf[_fast[k]] = k;
+	}
+	_contacts.resize(fastCount);
+	_boxMin.resize(fastCount);
+	_boxMax.resize(fastCount);
+
+	// grade das posicoes do fim do passo, para a busca das particulas lentas
+	_grid.Build(store, &simulation->_scheduler, simulation->_chunkSize);
+
+	// a busca de cada particula rapida so le o estado e escreve o proprio
+	// contato
+	simulation->_scheduler.ParallelFor(0, fastCount, simulation->_chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("ContinuousCollision::FindContacts", thread);
+		Vector3* position = store->_currPosition;
+		float* radius = store->_radius;
+
+		for(int k = begin; k < end; k++)
+		{
+			int a = _fast[k];
+			const Vector3& a0 = _start[a];
+			const Vector3& a1 = position[a];
+			float time = NO_CONTACT;
+			int other = count;
+
+			// planos: a esfera chega a distancia r do plano vinda da frente
+			for(int j = 0; j < (int)planes.size(); j++)
+			{
+				const Vector3& normal = planes[j]->_unitNormal;
+				float s0 = Dot(a0, normal) + planes[j]->_d - radius[a] * SEPARATION;
+				float s1 = Dot(a1, normal) + planes[j]->_d - radius[a] * SEPARATION;
+				if(s0 >= 0.0f && s1 < 0.0f)
+					Keep(time, other, s0 / (s0 - s1), -1 - j);
+			}
+
+			Vector3 lo(std::min(a0.x, a1.x) - radius[a], std::min(a0.y, a1.y) - radius[a], std::min(a0.z, a1.z) - radius[a]);
+			Vector3 hi(std::max(a0.x, a1.x) + radius[a], std::max(a0.y, a1.y) + radius[a], std::max(a0.z, a1.z) + radius[a]);
+			_boxMin[k] = lo;
+			_boxMax[k] = hi;
+
+			// particulas lentas: percorrem no passo no maximo um raio, de modo
+			// que a posicao final de uma que toca a varredura fica a menos de
+			// um diametro maximo (uma celula) da caixa varrida
+			auto visit = [&](int b)
+			{
+				if(_fastOf[b] >= 0)
+					return;
+				float t = SweptTime(a0, a1, _start[b], position[b], radius[a] + radius[b]);
+				if(t <= 1.0f)
+					Keep(time, other, t, b);
+			};
+
+			Vector3 margin(_grid._cellSize, _grid._cellSize, _grid._cellSize);
+			Vector3 queryLo = lo;
+			queryLo -= margin;
+			Vector3 queryHi = hi;
+			queryHi += margin;
+			if(!_grid.Query(queryLo, queryHi, _maxCells, visit))
+			{
+				for(int b = 0; b < count; b++)
+					visit(b);
+			}
+
+			_contacts[k]._time = time;
+			_contacts[k]._other = other;
+		}
+	});
+}
+
+void ContinuousCollision::FindFastPairs(ParticleStore* store)
+{
+	Vector3* position = store->_currPosition;
+	float* radius = store->_radius;
+	int fastCount = (int)_fast.size();
+
+	// varredura das caixas varridas das particulas rapidas no eixo de maior
+	// variancia dos centros, como em SweepAndPrune
+	double sum[3] = { 0.0, 0.0, 0.0 };
+	double sum2[3] = { 0.0, 0.0, 0.0 };
+	for(int k = 0; k < fastCount; k++)
+	{
+		for(int e = 0; e < 3; e++)
+		{
+			double center = 0.5 * ((&_boxMin[k].x)[e] + (&_boxMax[k].x)[e]);
+			sum[e] += center;
+			sum2[e] += center * center;
+		}
+	}
+	int axis = 0;
+	double best = -1.0;
+	for(int e = 0; e < 3; e++)
+	{
+		double variance = sum2[e] - sum[e] * sum[e] / fastCount;
+		if(variance > best)
+		{
+			best = variance;
+			axis = e;
+		}
+	}
+	int axis1 = (axis + 1) % 3;
+	int axis2 = (axis + 2) % 3;
+
+	_order.resize(fastCount);
+	for(int k = 0; k < fastCount; k++)
+	{
+		_order[k] = k;
+	}
+	std::vector<Vector3>& boxMin = _boxMin;
+	std::sort(_order.begin(), _order.end(), [&](int i, int j)
+	{
+		float mi = (&boxMin[i].x)[axis];
+		float mj = (&boxMin[j].x)[axis];
+		return mi < mj || (mi == mj && i < j);
+	});
+
+	for(int m = 0; m < fastCount; m++)
+	{
+		int i = _order[m];
+		const float* minI = &_boxMin[i].x;
+		const float* maxI = &_boxMax[i].x;
+		for(int n = m + 1; n < fastCount; n++)
+		{
+			int j = _order[n];
+			const float* minJ = &_boxMin[j].x;
+			const float* maxJ = &_boxMax[j].x;
+			if(minJ[axis] > maxI[axis])
+				break;
+			if(minJ[axis1] > maxI[axis1] || maxJ[axis1] < minI[axis1] ||
+				minJ[axis2] > maxI[axis2] || maxJ[axis2] < minI[axis2])
+				continue;
+
+			int a = _fast[i];
+			int b = _fast[j];
+			float t = SweptTime(_start[a], position[a], _start[b], position[b], radius[a] + radius[b]);
+			if(t <= 1.0f)
+			{
+				Keep(_contacts[i]._time, _contacts[i]._other, t, b);
+				Keep(_contacts[j]._time, _contacts[j]._other, t, a);
+			}
+		}
+	}
+}
+
+void ContinuousCollision::Apply(Simulation* simulation)
+{
+	ParticleStore* store = &simulation->_store;
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+	float dissipative = simulation->_dissipative;
+
+	_handled.assign(store->_count, 0);
+
+	for(int k = 0; k < (int)_fast.size(); k++)
+	{
+		int a = _fast[k];
+		float t = _contacts[k]._time;
+		int b = _contacts[k]._other;
+		if(t > 1.0f || _handled[a] || (b >= 0 && _handled[b]))
+			continue;
+
+		// a particula para no ponto do contato
+		Vector3 move = position[a];
+		move -= _start[a];
+		move *= t;
+		position[a] = _start[a];
+		position[a] += move;
+		_handled[a] = 1;
+		_impacts++;
+
+		Vector3 normal;
+		if(b < 0)
+		{
+			normal = simulation->_planes[-1 - b]->_unitNormal;
+		}
+		else
+		{
+			move = position[b];
+			move -= _start[b];
+			move *= t;
+			position[b] = _start[b];
+			position[b] += move;
+			_handled[b] = 1;
+
+			if(store->_particleType[b] == Particle::SLEEPING)
+				simulation->_islands.Wake(store, b);
+
+			normal = position[a];
+			normal -= position[b];
+			normal.Normalize();
+
+			Vector3 tb = normal;
+			tb *= 2.0f * Dot(velocity[b], normal);
+			velocity[b] -= tb;
+			velocity[b] *= dissipative;
+		}
+
+		Vector3 ta = normal;
+		ta *= 2.0f * Dot(velocity[a], normal);
+		velocity[a] -= ta;
+		velocity[a] *= dissipative;
+	}
+}
+
+void ContinuousCollision::Collide(Simulation* simulation)
+{
+	_fastCount = 0;
+	_impacts = 0;
+
+	ParticleStore* store = &simulation->_store;
+	if(!_enabled || (int)_start.size() != store->_count)
+		return;
+
+	FindFast(store);
+	_fastCount = (int)_fast.size();
+	if(_fast.empty())
+		return;
+
+	FindContacts(simulation);
+	FindFastPairs(store);
+	Apply(simulation);
+}
@@ -0,0 +1,81 @@
+// continuouscollision.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef CONTINUOUSCOLLISION_H
+#define CONTINUOUSCOLLISION_H
+
+#include <vector>
+
+#include "grid.h"
+#include "vector.h"
+
+class Simulation;
+class ParticleStore;
+
+// Deteccao continua de colisao (CCD) das particulas rapidas. Os testes
+// discretos so veem as posicoes do fim do passo: uma particula que percorre
+// mais que o seu raio em um passo pode atravessar outra particula ou passar
+// do plano para o lado de fora de outro plano (nos cantos da caixa). Em vez
+// de reduzir o passo de todas, so as particulas rapidas, cujo deslocamento
+// no passo passa do raio, varrem a esfera ao longo do segmento do passo
+// contra os planos e contra as demais particulas (tambem varridas em linha
+// reta). O primeiro contato de cada particula rapida leva a particula ao
+// ponto do contato, onde o resto do movimento do passo e descartado, e
+// reflete as velocidades como os testes discretos. Os contatos sao aplicados
+// na ordem das particulas; uma particula ja atingida no passo ignora os
+// contatos seguintes, que foram calculados com o seu movimento antigo.
+// Obstaculos SDF e malhas continuam so com o teste discreto (as malhas
+// contam com _thickness).
+class ContinuousCollision
+{
+public:
+	ContinuousCollision();
+
+	bool _enabled;
+	// celulas da grade alem das quais a busca de uma particula percorre
+	// todas as particulas
+	int _maxCells;
+
+	// estatisticas do ultimo passo: particulas rapidas e contatos aplicados
+	int _fastCount;
+	int _impacts;
+
+	// Guarda as posicoes do inicio do passo; chamado antes da integracao
+	void Begin(ParticleStore* store);
+
+	// Procura e aplica o primeiro contato de cada particula rapida; chamado
+	// depois da integracao
+	void Collide(Simulation* simulation);
+
+private:
+	// primeiro contato de uma particula rapida: fracao do passo (maior que
+	// 1 sem contato) e particula atingida, ou -1 - indice do plano
+	struct Contact
+	{
+		float _time;
+		int _other;
+	};
+
+	std::vector<Vector3> _start;
+	// particulas rapidas em ordem de indice e posicao de cada particula
+	// nessa lista (-1 para as lentas)
+	std::vector<int> _fast;
+	std::vector<int> _fastOf;
+	std::vector<Contact> _contacts;
+	// caixas varridas das rapidas (minimo e maximo) e rapidas ordenadas pelo
+	// minimo em x
+	std::vector<Vector3> _boxMin;
+	std::vector<Vector3> _boxMax;
+	std::vector<int> _order;
+	std::vector<unsigned char> _handled;
+	Grid _grid;
+
+	void FindFast(ParticleStore* store);
+	void FindContacts(Simulation* simulation);
+	void FindFastPairs(ParticleStore* store);
+	void Apply(Simulation* simulation);
+};
+
+#endif
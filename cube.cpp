@@ -5,14 +5,25 @@
 
 #include "graphics.h"
 
+#include "particlestore.h"
 #include "cube.h"
 
 Cube::Cube()
 {
+	_store = 0;
+	_firstParticle = 0;
+	_particles = 0;
 }
 
 Cube::~Cube()
 {
+	ReleaseParticles();
+}
+
+void Cube::ReleaseParticles()
+{
+	delete[] _particles;
+	_particles = 0;
 }
 
 void Cube::Initialize(float mass, 
@@ -25,6 +36,8 @@ void Cube::Initialize(float mass,
 {
 	_mass = mass/8;
 	_radius = radius;
+	ReleaseParticles();
+	_particles = new Particle[VERTICES];
 	_particles[0].Initialize(_mass, _radius, xMin, yMax, zMin, r, g, b, type);
 	_particles[1].Initialize(_mass, _radius, xMax, yMax, zMin, r, g, b, type);
 	_particles[2].Initialize(_mass, _radius, xMax, yMax, zMax, r, g, b, type);
@@ -41,13 +54,10 @@ void Cube::Update()
 
 void Cube::Draw()
 {
-	float coord[FACES * 4];
-	for(int i = 0; i < VERTICES; i++)
-	{
-		coord[i*3+0] = _particles[i]._currPosition.x; 
-		coord[i*3+1] = _particles[i]._currPosition.y; 
-		coord[i*3+2] = _particles[i]._currPosition.z;
-	}
+	// os vertices sao indices no armazenamento do sistema, traduzidos pela
+	// tabela de identificadores (as particulas podem ter sido reordenadas)
+	float* coord = &_store->_currPosition[0].x;
+	const int* slot = &_store->_slot[_firstParticle];
 	
 	unsigned int quads[FACES * 4] = 
 	{
@@ -58,6 +68,13 @@ void Cube::Draw()
 		2, 3, 7, 6,
 		0, 4, 7, 3
 	};
+	for(int i = 0; i < FACES * 4; i++)
+	{
+		// cubo com particulas removidas nao e desenhado
+		if(slot[quads[i]] < 0)
+			return;
+		quads[i] = slot[quads[i]];
+	}
 
 	Graphics::DrawQuads(
 		FACES * 4, quads, coord, _red, _green, _blue);
@@ -11,6 +11,8 @@
 #define FACES 6
 #define VERTICES 8
 
+class ParticleStore;
+
 class Cube
 {
 public:
@@ -20,7 +22,12 @@ public:
 	float _mass;
 	float _radius;
 	float _red, _green, _blue;
-	Particle _particles[VERTICES];
+	// estado inicial das particulas, montado por Initialize e copiado para o
+	// ParticleStore por Simulation::AddCube, que o libera; depois disso
+	// as particulas sao lidas do store pelo intervalo de identificadores
+	Particle* _particles;
+	ParticleStore* _store;
+	int _firstParticle;
 
 	void Initialize(float mass, 
 					float radius,
@@ -29,6 +36,7 @@ public:
 		float zMin, float zMax,
 		float r, float g, float b,
 		Particle::ParticleType type);
+	void ReleaseParticles();
 	void Update();
     void Draw();
 };
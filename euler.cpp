@@ -4,20 +4,26 @@
 // PUC-Rio, Set 2009
 
 #include "vector.h"
-#include "particle.h"
+#include "particlestore.h"
 #include "euler.h"
 
 Euler::Euler()
 {
+	_integratorType = EULER;
 }
 
-void Euler::Integrate(Vector3 acceleration, Particle* particle)
+inline void Euler::Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const
 {
-	particle->_currPosition.x += particle->_currVelocity.x * _fixedTimeStep;
-	particle->_currPosition.y += particle->_currVelocity.y * _fixedTimeStep;
-	particle->_currPosition.z += particle->_currVelocity.z * _fixedTimeStep;
+	position.x += velocity.x * _fixedTimeStep;
+	position.y += velocity.y * _fixedTimeStep;
+	position.z += velocity.z * _fixedTimeStep;
 	
-	particle->_currVelocity.x += acceleration.x * _fixedTimeStep;
-	particle->_currVelocity.y += acceleration.y * _fixedTimeStep;
-	particle->_currVelocity.z += acceleration.z * _fixedTimeStep;
+	velocity.x += acceleration.x * _fixedTimeStep;
+	velocity.y += acceleration.y * _fixedTimeStep;
+	velocity.z += acceleration.z * _fixedTimeStep;
+}
+
+void Euler::Integrate(ParticleStore* store, int stage, int begin, int end)
+{
+	IntegrateRange(*this, store, begin, end);
 }
\ No newline at end of file
@@ -8,14 +8,13 @@
 
 #include "integrator.h"
 
-struct Vector3;
-
-class Euler : Integrator
+class Euler : public Integrator
 {
 public:
 	Euler();
 	
-    void Integrate(Vector3 acceleration, Particle* particle);
+	void Integrate(ParticleStore* store, int stage, int begin, int end);
+	void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
 };
 
 #endif
\ No newline at end of file
@@ -7,12 +7,13 @@
 
 ForceGenerator::ForceGenerator()
 {
+	_forceGeneratorType = NONE;
 }
 
 ForceGenerator::~ForceGenerator()
 {
 }
 
-void ForceGenerator::ApplyForce(Particle* particle)
+void ForceGenerator::ApplyForce(ParticleStore* store, int begin, int end)
 {
 }
\ No newline at end of file
@@ -6,14 +6,23 @@
 #ifndef FORCE_GENERATOR_H
 #define FORCE_GENERATOR_H
 
-class Particle;
+class ParticleStore;
 
 class ForceGenerator
 {
 public:
+	enum ForceGeneratorType
+	{
+		NONE,
+		GRAVITY,
+		MEDIUM
+	};
+
 	ForceGenerator();
 	virtual ~ForceGenerator();
-	virtual void ApplyForce(Particle* particle);
+	virtual void ApplyForce(ParticleStore* store, int begin, int end);
+
+	ForceGeneratorType _forceGeneratorType;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+// graphicsnull.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+// Implementacao vazia de Graphics para os executaveis sem janela: permite
+// ligar o nucleo da simulacao sem OpenGL nem GLUT.
+
+#include "graphics.h"
+
+void Graphics::BeginDrawing ()
+{
+}
+
+void Graphics::EndDrawing ()
+{
+}
+
+void Graphics::LoadCamera 
+(float angle, 
+ float x, float y, float z, 
+ float cx, float cy, float cz, 
+ float ux, float uy, float uz
+ )
+{
+}
+
+void Graphics::DrawPlane 
+(float x, float y, float z, float nx, float ny, float nz,
+ float size,
+ float r, float g, float b
+ )
+{
+}
+
+void Graphics::DrawSphere 
+(float radius, float x, float y, float z, float r, float g, float b)
+{
+}
+
+void Graphics::DrawSphereParticles 
+(int n, float radius, float* coord, float* color)
+{
+}
+
+void Graphics::DrawPointParticles 
+(int n, float size, float* coord, float* color)
+{
+}
+
+void Graphics::DrawSpring 
+(float width, float lrest, float *coord1, float* coord2)
+{
+}
+
+void Graphics::DrawQuads 
+(int n, unsigned int* ind, float* coord, float r, float g, float b)
+{
+}
+
+void Graphics::DrawTriangles 
+(int n, unsigned int* ind, float* coord, float r, float g, float b)
+{
+}
+
+void Graphics::DrawLine
+(float x1, float y1, float z1, float x2, float y2, float z2)
+{
+}
@@ -3,11 +3,12 @@
 // L. Camello - camello@tecgraf.puc-rio.br
 // PUC-Rio, Set 2009
 
-#include "particle.h"
+#include "particlestore.h"
 #include "gravity.h"
 
 Gravity::Gravity()
 {
+	_forceGeneratorType = GRAVITY;
 	_acceleration = Vector3(0.0f, -9.8f, 0.0f);
 }
 
@@ -17,12 +18,22 @@ Gravity::~Gravity()
 
 Gravity::Gravity(Vector3 acceleration)
 {
+	_forceGeneratorType = GRAVITY;
 	_acceleration = acceleration;
 }
 
-void Gravity::ApplyForce(Particle* particle)
+void Gravity::ApplyForce(ParticleStore* store, int begin, int end)
 {
-	particle->_resultantForce.x += particle->_mass * _acceleration.x;
-	particle->_resultantForce.y += particle->_mass * _acceleration.y;
-	particle->_resultantForce.z += particle->_mass * _acceleration.z;
+	Vector3* force = store->_resultantForce;
+	float* mass = store->_mass;
+
+	for(int i = begin; i < end; i++)
+	{
+		if(store->_particleType[i] == Particle::ParticleType::ACTIVE)
+		{
+			force[i].x += mass[i] * _acceleration.x;
+			force[i].y += mass[i] * _acceleration.y;
+			force[i].z += mass[i] * _acceleration.z;
+		}
+	}
 }
\ No newline at end of file
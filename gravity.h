@@ -19,7 +19,7 @@ public:
 
 	Vector3 _acceleration;
 
-	void ApplyForce(Particle* particle);
+	void ApplyForce(ParticleStore* store, int begin, int end);
 };
 
 #endif
\ No newline at end of file
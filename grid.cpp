@@ -0,0 +1,160 @@
+// grid.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+
+#include "profiler.h"
+#include "scheduler.h"
+#include "particlestore.h"
+#include "grid.h"
+
+Grid::Grid()
+{
+	_cellSize = 1.0f;
+	_tableMask = 0;
+}
+
+Grid::~Grid()
+{
+}
+
+void Grid::Build(ParticleStore* store, Scheduler* scheduler, int chunk)
+{
+	int count = store->_count;
+	Vector3* position = store->_currPosition;
+
+	// a celula e dimensionada pelo maior diametro do sistema
+	float maxRadius = 0.0f;
+	for(int i = 0; i < count; i++)
+	{
+		if(store->_radius[i] > maxRadius)
+			maxRadius = store->_radius[i];
+	}
+	_cellSize = maxRadius > 0.0f ? 2.0f * maxRadius : 1.0f;
+
+	// tabela com pelo menos o dobro de entradas que particulas
+	int tableSize = 1;
+	while(tableSize < 2 * count)
+		tableSize <<= 1;
+	_tableMask = tableSize - 1;
+
+	_cellStart.assign(tableSize + 1, 0);
+	_cellOf.resize(count);
+	_sorted.resize(count);
+
+	scheduler->ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+	{
+		for(int i = begin; i < end; i++)
+		{
+			Vector3& p = position[i];
+			_cellOf[i] = Hash(Cell(p.x), Cell(p.y), Cell(p.z));
+		}
+	});
+
+	// ordenacao por contagem das particulas por celula
+	for(int i = 0; i < count; i++)
+	{
+		_cellStart[_cellOf[i] + 1]++;
+	}
+	for(int c = 0; c < tableSize; c++)
+	{
+		_cellStart[c + 1] += _cellStart[c];
+	}
+	std::vector<int> next(_cellStart.begin(), _cellStart.end() - 1);
+	for(int i = 0; i < count; i++)
+	{
+		_sorted[next[_cellOf[i]]++] = i;
+	}
+}
+
+int Grid::FindPairs(ParticleStore* store, Scheduler* scheduler, int chunk, std::vector<int>& pairs)
+{
+	int count = store->_count;
+
+	pairs.clear();
+	if(count < 2)
+		return 0;
+
+	{
+		PROFILE_ZONE("Grid::Build", 0);
+		Build(store, scheduler, chunk);
+	}
+
+	int chunks = (count + chunk - 1) / chunk;
+	if((int)_chunkPairs.size() < chunks)
+		_chunkPairs.resize(chunks);
+
+	scheduler->ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("Grid::FindPairs", thread);
+		std::vector<int>& chunkPairs = _chunkPairs[begin / chunk];
+		chunkPairs.clear();
+		FindPairs(store, begin, end, chunkPairs);
+	});
+
+	for(int c = 0; c < chunks; c++)
+	{
+		pairs.insert(pairs.end(), _chunkPairs[c].begin(), _chunkPairs[c].end());
+	}
+
+	return (int)pairs.size() / 2;
+}
+
+void Grid::FindPairs(ParticleStore* store, int begin, int end, std::vector<int>& pairs)
+{
+	Vector3* position = store->_currPosition;
+	const Particle::ParticleType* type = store->_particleType;
+
+	int visited[27];
+	for(int i = begin; i < end; i++)
+	{
+		// particulas adormecidas nao procuram pares; os pares entre uma
+		// adormecida e uma acordada sao emitidos pela acordada
+		if(type[i] == Particle::SLEEPING)
+			continue;
+
+		Vector3& p = position[i];
+		int cx = Cell(p.x);
+		int cy = Cell(p.y);
+		int cz = Cell(p.z);
+
+		// percorre as 27 celulas vizinhas, ignorando entradas repetidas
+		// da tabela para que nenhum par seja emitido duas vezes
+		int nVisited = 0;
+		for(int dx = -1; dx <= 1; dx++)
+		{
+			for(int dy = -1; dy <= 1; dy++)
+			{
+				for(int dz = -1; dz <= 1; dz++)
+				{
+					int cell = Hash(cx + dx, cy + dy, cz + dz);
+
+					bool seen = false;
+					for(int k = 0; k < nVisited; k++)
+					{
+						if(visited[k] == cell)
+						{
+							seen = true;
+							break;
+						}
+					}
+					if(seen)
+						continue;
+					visited[nVisited++] = cell;
+
+					for(int k = _cellStart[cell]; k < _cellStart[cell + 1]; k++)
+					{
+						int j = _sorted[k];
+						if(j > i || type[j] == Particle::SLEEPING)
+						{
+							pairs.push_back(i);
+							pairs.push_back(j);
+						}
+					}
+				}
+			}
+		}
+	}
+}
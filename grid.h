@@ -0,0 +1,107 @@
+// grid.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef GRID_H
+#define GRID_H
+
+#include <math.h>
+#include <vector>
+
+#include "vector.h"
+
+class Scheduler;
+class ParticleStore;
+
+// maior indice de celula em cada eixo (2^30)
+#define GRID_CELL_LIMIT 1073741824.0f
+
+// Grade uniforme (hash espacial) para a fase larga da colisao entre particulas.
+// O tamanho da celula e o maior diametro entre as particulas, de modo que dois
+// corpos em contato sempre estao em celulas vizinhas. Cada par candidato e
+// emitido uma unica vez, com i < j (ou pela particula acordada, se a outra
+// esta adormecida). A busca e dividida em blocos de
+// particulas; os pares de cada bloco sao concatenados na ordem dos blocos, de
+// modo que o resultado nao depende do numero de threads.
+class Grid
+{
+public:
+	Grid();
+	~Grid();
+
+	float _cellSize;
+	int _tableMask;
+	std::vector<int> _cellStart;
+	std::vector<int> _cellOf;
+	std::vector<int> _sorted;
+	std::vector<std::vector<int> > _chunkPairs;
+
+	// Preenche pairs com os pares candidatos (2 indices por par); retorna o
+	// numero de pares
+	int FindPairs(ParticleStore* store, Scheduler* scheduler, int chunk, std::vector<int>& pairs);
+
+	// Distribui as particulas nas celulas pelas posicoes atuais
+	void Build(ParticleStore* store, Scheduler* scheduler, int chunk);
+
+	// Visita (visit(i)) as particulas das celulas que tocam a caixa [lo, hi],
+	// depois de Build. Celulas que caem na mesma entrada da tabela repetem
+	// particulas. Retorna false, sem visitar nenhuma, se a caixa cobre mais
+	// que maxCells celulas.
+	template <class F>
+	bool Query(const Vector3& lo, const Vector3& hi, int maxCells, F visit)
+	{
+		int x0 = Cell(lo.x), x1 = Cell(hi.x);
+		int y0 = Cell(lo.y), y1 = Cell(hi.y);
+		int z0 = Cell(lo.z), z1 = Cell(hi.z);
+		double cells = (double)(x1 - x0 + 1) * (double)(y1 - y0 + 1) * (double)(z1 - z0 + 1);
+		if(!(cells <= maxCells))
+			return false;
+
+		// a celula vazia e o caso comum: os limites sao lidos uma vez por celula
+		const int* start = &_cellStart[0];
+		const int* sorted = _sorted.empty() ? 0 : &_sorted[0];
+		for(int x = x0; x <= x1; x++)
+		{
+			for(int y = y0; y <= y1; y++)
+			{
+				for(int z = z0; z <= z1; z++)
+				{
+					int cell = Hash(x, y, z);
+					int end = start[cell + 1];
+					for(int k = start[cell]; k < end; k++)
+					{
+						visit(sorted[k]);
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+	void FindPairs(ParticleStore* store, int begin, int end, std::vector<int>& pairs);
+	// no cabecalho para que Query, instanciada fora de grid.cpp, os expanda
+	int Hash(int x, int y, int z)
+	{
+		unsigned int h = ((unsigned int)x * 73856093u) ^
+			((unsigned int)y * 19349663u) ^
+			((unsigned int)z * 83492791u);
+		return (int)(h & (unsigned int)_tableMask);
+	}
+
+	// A conversao para int de um valor fora da faixa e indefinida: celulas
+	// alem de +/-2^30 (e coordenadas NaN) ficam na celula limite, que ainda
+	// deixa folga para as vizinhas
+	int Cell(float v)
+	{
+		float cell = floorf(v / _cellSize);
+		if(!(cell > -GRID_CELL_LIMIT))
+			return -(int)GRID_CELL_LIMIT;
+		if(cell > GRID_CELL_LIMIT)
+			return (int)GRID_CELL_LIMIT;
+		return (int)cell;
+	}
+};
+
+#endif
@@ -0,0 +1,384 @@
+// impliciteuler.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "vector.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "impliciteuler.h"
+
+ImplicitEuler::ImplicitEuler()
+{
+	_integratorType = IMPLICIT_EULER;
+	_tolerance = 1e-5f;
+	_maxIterations = 200;
+	_iterations = 0;
+	_patternVersion = -1;
+	_patternParticles = -1;
+}
+
+// Inversa de um bloco 3x3 (ordem de linha) pela matriz adjunta
+static void InvertBlock(const float* m, float* inverse)
+{
+	float c0 = m[4] * m[8] - m[5] * m[7];
+	float c1 = m[5] * m[6] - m[3] * m[8];
+	float c2 = m[3] * m[7] - m[4] * m[6];
+	float determinant = m[0] * c0 + m[1] * c1 + m[2] * c2;
+	if(determinant == 0.0f)
+	{
+		inverse[0] = inverse[4] = inverse[8] = 1.0f;
+		inverse[1] = inverse[2] = inverse[3] = inverse[5] = inverse[6] = inverse[7] = 0.0f;
+		return;
+	}
+	float d = 1.0f / determinant;
+	inverse[0] = c0 * d;
+	inverse[1] = (m[2] * m[7] - m[1] * m[8]) * d;
+	inverse[2] = (m[1] * m[5] - m[2] * m[4]) * d;
+	inverse[3] = c1 * d;
+	inverse[4] = (m[0] * m[8] - m[2] * m[6]) * d;
+	inverse[5] = (m[2] * m[3] - m[0] * m[5]) * d;
+	inverse[6] = c2 * d;
+	inverse[7] = (m[1] * m[6] - m[0] * m[7]) * d;
+	inverse[8] = (m[0] * m[4] - m[1] * m[3]) * d;
+}
+
+static inline void MultiplyBlock(const float* m, const Vector3& v, Vector3& result)
+{
+	result.x = m[0] * v.x + m[1] * v.y + m[2] * v.z;
+	result.y = m[3] * v.x + m[4] * v.y + m[5] * v.z;
+	result.z = m[6] * v.x + m[7] * v.y + m[8] * v.z;
+}
+
+// Soma ao bloco 3x3 o bloco simetrico s (xx, yy, zz, xy, xz, yz) vezes sign
+static inline void AddSymmetric(float* m, const float* s, float sign)
+{
+	m[0] += sign * s[0];
+	m[4] += sign * s[1];
+	m[8] += sign * s[2];
+	m[1] += sign * s[3];
+	m[3] += sign * s[3];
+	m[2] += sign * s[4];
+	m[6] += sign * s[4];
+	m[5] += sign * s[5];
+	m[7] += sign * s[5];
+}
+
+void ImplicitEuler::BuildPattern(Simulation* simulation)
+{
+	SpringTable& springs = simulation->_springs;
+	int count = simulation->_store._count;
+
+	_matrix.BuildPattern(count, springs._particleA, springs._particleB, springs._count);
+
+	// bloco de cada entrada da incidencia: (particula, outro extremo)
+	_incidentBlock.resize(springs._incident.size());
+	for(int i = 0; i < count; i++)
+	{
+		for(int k = springs._incidentStart[i]; k < springs._incidentStart[i + 1]; k++)
+		{
+			int s = springs._incident[k];
+			int other = s >= 0 ? springs._particleB[s] : springs._particleA[~s];
+			_incidentBlock[k] = _matrix.Find(i, other);
+		}
+	}
+
+	_patternVersion = springs._version;
+	_patternParticles = count;
+
+	// a estimativa inicial nao corresponde mais as mesmas particulas
+	_deltaVelocity.assign(count, Vector3(0.0f, 0.0f, 0.0f));
+}
+
+void ImplicitEuler::Assemble(Simulation* simulation, int begin, int end)
+{
+	ParticleStore& store = simulation->_store;
+	SpringTable& springs = simulation->_springs;
+	const Particle::ParticleType* type = store._particleType;
+	float h = _fixedTimeStep;
+
+	_matrix.Clear(begin, end);
+
+	for(int i = begin; i < end; i++)
+	{
+		float* diagonal = &_matrix._blocks[_matrix._diagonal[i] * 9];
+		Vector3& rhs = _rhs[i];
+
+		if(type[i] != Particle::ACTIVE)
+		{
+			diagonal[0] = diagonal[4] = diagonal[8] = 1.0f;
+			rhs.x = rhs.y = rhs.z = 0.0f;
+		}
+		else
+		{
+			diagonal[0] = diagonal[4] = diagonal[8] = store._mass[i];
+			rhs.x = h * store._resultantForce[i].x;
+			rhs.y = h * store._resultantForce[i].y;
+			rhs.z = h * store._resultantForce[i].z;
+
+			// A_ii -= J, A_ij += J; o termo h^2 K v troca de sinal no extremo B
+			for(int k = springs._incidentStart[i]; k < springs._incidentStart[i + 1]; k++)
+			{
+				int s = springs._incident[k];
+				float sign = 1.0f;
+				int other;
+				if(s >= 0)
+				{
+					other = springs._particleB[s];
+				}
+				else
+				{
+					s = ~s;
+					sign = -1.0f;
+					other = springs._particleA[s];
+				}
+
+				const float* jacobian = &_jacobian[s * 6];
+				AddSymmetric(diagonal, jacobian, -1.0f);
+				if(type[other] == Particle::ACTIVE)
+					AddSymmetric(&_matrix._blocks[_incidentBlock[k] * 9], jacobian, 1.0f);
+
+				rhs.x += sign * _springTerm[s].x;
+				rhs.y += sign * _springTerm[s].y;
+				rhs.z += sign * _springTerm[s].z;
+			}
+		}
+
+		InvertBlock(diagonal, &_preconditioner[i * 9]);
+	}
+}
+
+void ImplicitEuler::Prepare(Simulation* simulation)
+{
+	PROFILE_ZONE("ImplicitEuler::Prepare", 0);
+
+	ParticleStore& store = simulation->_store;
+	SpringTable& springs = simulation->_springs;
+	int count = store._count;
+	int chunk = simulation->_chunkSize > 0 ? simulation->_chunkSize : 1;
+
+	springs.BuildIncidence(count);
+	if(springs._version != _patternVersion || count != _patternParticles)
+		BuildPattern(simulation);
+
+	// o ultimo dv serve de estimativa inicial; particulas novas comecam em 0
+	_deltaVelocity.resize(count, Vector3(0.0f, 0.0f, 0.0f));
+	_rhs.resize(count);
+	_residual.resize(count);
+	_search.resize(count);
+	_product.resize(count);
+	_preconditioned.resize(count);
+	_preconditioner.resize(count * 9);
+	_jacobian.resize(springs._count * 6);
+	_springTerm.resize(springs._count);
+	_partial.resize((count + chunk - 1) / chunk);
+	_partial2.resize(_partial.size());
+
+	// jacobianos de cada mola:
+	//   K = -k (n n^T + max(0, 1 - L/l) (I - n n^T))
+	//   D = -c n n^T
+	// o termo transversal e descartado em compressao para manter A definida
+	float h = _fixedTimeStep;
+	const Vector3* position = store._currPosition;
+	const Vector3* velocity = store._currVelocity;
+	simulation->_scheduler.ParallelFor(0, springs._count, chunk, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("ImplicitEuler::Jacobians", thread);
+		for(int s = begin; s < end; s++)
+		{
+			int a = springs._particleA[s];
+			int b = springs._particleB[s];
+			float* jacobian = &_jacobian[s * 6];
+
+			Vector3 direction = position[a];
+			direction -= position[b];
+			float length = direction.Length();
+			if(length == 0.0f)
+			{
+				for(int k = 0; k < 6; k++)
+					jacobian[k] = 0.0f;
+				_springTerm[s] = Vector3(0.0f, 0.0f, 0.0f);
+				continue;
+			}
+			direction *= 1.0f / length;
+
+			float stiffness = springs._stiffness[s];
+			float transverse = 1.0f - springs._restLength[s] / length;
+			if(transverse < 0.0f)
+				transverse = 0.0f;
+
+			// J = h D + h^2 K = -alpha n n^T - beta I
+			float alpha = h * springs._damping[s] + h * h * stiffness * (1.0f - transverse);
+			float beta = h * h * stiffness * transverse;
+			float nx = direction.x, ny = direction.y, nz = direction.z;
+			jacobian[0] = -alpha * nx * nx - beta;
+			jacobian[1] = -alpha * ny * ny - beta;
+			jacobian[2] = -alpha * nz * nz - beta;
+			jacobian[3] = -alpha * nx * ny;
+			jacobian[4] = -alpha * nx * nz;
+			jacobian[5] = -alpha * ny * nz;
+
+			// h^2 K (va - vb)
+			Vector3 relativeVelocity = velocity[a];
+			relativeVelocity -= velocity[b];
+			float along = Dot(direction, relativeVelocity);
+			float kappa = h * h * stiffness;
+			_springTerm[s].x = -kappa * ((1.0f - transverse) * along * nx + transverse * relativeVelocity.x);
+			_springTerm[s].y = -kappa * ((1.0f - transverse) * along * ny + transverse * relativeVelocity.y);
+			_springTerm[s].z = -kappa * ((1.0f - transverse) * along * nz + transverse * relativeVelocity.z);
+		}
+	});
+
+	simulation->_scheduler.ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("ImplicitEuler::Assemble", thread);
+		Assemble(simulation, begin, end);
+	});
+
+	Solve(simulation);
+}
+
+// Gradientes conjugados precondicionados. Cada varredura e dividida nos
+// blocos do escalonador; os produtos internos sao somados por bloco e
+// reduzidos em ordem, de modo que o resultado nao depende do numero de
+// threads.
+void ImplicitEuler::Solve(Simulation* simulation)
+{
+	PROFILE_ZONE("ImplicitEuler::Solve", 0);
+
+	Scheduler& scheduler = simulation->_scheduler;
+	int count = simulation->_store._count;
+	int chunk = simulation->_chunkSize > 0 ? simulation->_chunkSize : 1;
+	int chunks = (int)_partial.size();
+
+	_iterations = 0;
+	if(count == 0)
+		return;
+
+	Vector3* x = &_deltaVelocity[0];
+	Vector3* b = &_rhs[0];
+	Vector3* r = &_residual[0];
+	Vector3* p = &_search[0];
+	Vector3* q = &_product[0];
+	Vector3* z = &_preconditioned[0];
+	const float* preconditioner = &_preconditioner[0];
+	BlockMatrix& matrix = _matrix;
+
+	// r = b - A x, z = P r, p = z
+	scheduler.ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+	{
+		matrix.Multiply(x, q, begin, end);
+		double rz = 0.0, bb = 0.0;
+		for(int i = begin; i < end; i++)
+		{
+			r[i].x = b[i].x - q[i].x;
+			r[i].y = b[i].y - q[i].y;
+			r[i].z = b[i].z - q[i].z;
+			MultiplyBlock(&preconditioner[i * 9], r[i], z[i]);
+			p[i] = z[i];
+			rz += Dot(r[i], z[i]);
+			bb += Dot(b[i], b[i]);
+		}
+		_partial[begin / chunk] = rz;
+		_partial2[begin / chunk] = bb;
+	});
+
+	double rz = 0.0, bb = 0.0;
+	for(int c = 0; c < chunks; c++)
+	{
+		rz += _partial[c];
+		bb += _partial2[c];
+	}
+	if(bb == 0.0)
+	{
+		for(int i = 0; i < count; i++)
+			x[i] = Vector3(0.0f, 0.0f, 0.0f);
+		return;
+	}
+	double threshold = (double)_tolerance * _tolerance * bb;
+
+	while(_iterations < _maxIterations)
+	{
+		// q = A p
+		scheduler.ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+		{
+			matrix.Multiply(p, q, begin, end);
+			double pq = 0.0;
+			for(int i = begin; i < end; i++)
+				pq += Dot(p[i], q[i]);
+			_partial[begin / chunk] = pq;
+		});
+
+		double pq = 0.0;
+		for(int c = 0; c < chunks; c++)
+			pq += _partial[c];
+		if(pq <= 0.0)
+			break;
+		float alpha = (float)(rz / pq);
+
+		// x += alpha p, r -= alpha q, z = P r
+		scheduler.ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+		{
+			double rzPartial = 0.0, rrPartial = 0.0;
+			for(int i = begin; i < end; i++)
+			{
+				x[i].x += alpha * p[i].x;
+				x[i].y += alpha * p[i].y;
+				x[i].z += alpha * p[i].z;
+				r[i].x -= alpha * q[i].x;
+				r[i].y -= alpha * q[i].y;
+				r[i].z -= alpha * q[i].z;
+				MultiplyBlock(&preconditioner[i * 9], r[i], z[i]);
+				rzPartial += Dot(r[i], z[i]);
+				rrPartial += Dot(r[i], r[i]);
+			}
+			_partial[begin / chunk] = rzPartial;
+			_partial2[begin / chunk] = rrPartial;
+		});
+		_iterations++;
+
+		double rzNext = 0.0, rr = 0.0;
+		for(int c = 0; c < chunks; c++)
+		{
+			rzNext += _partial[c];
+			rr += _partial2[c];
+		}
+		if(rr <= threshold)
+			break;
+
+		// p = z + beta p
+		float beta = (float)(rzNext / rz);
+		rz = rzNext;
+		scheduler.ParallelFor(0, count, chunk, [&](int begin, int end, int thread)
+		{
+			for(int i = begin; i < end; i++)
+			{
+				p[i].x = z[i].x + beta * p[i].x;
+				p[i].y = z[i].y + beta * p[i].y;
+				p[i].z = z[i].z + beta * p[i].z;
+			}
+		});
+	}
+}
+
+inline void ImplicitEuler::Update::Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const
+{
+	velocity += _deltaVelocity[index];
+
+	previous = position;
+
+	position.x += velocity.x * _timeStep;
+	position.y += velocity.y * _timeStep;
+	position.z += velocity.z * _timeStep;
+}
+
+void ImplicitEuler::Integrate(ParticleStore* store, int stage, int begin, int end)
+{
+	if(begin >= end)
+		return;
+
+	Update policy;
+	policy._deltaVelocity = &_deltaVelocity[0];
+	policy._timeStep = _fixedTimeStep;
+	IntegrateRange(policy, store, begin, end);
+}
@@ -0,0 +1,76 @@
+// impliciteuler.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef IMPLICITEULER_H
+#define IMPLICITEULER_H
+
+#include <vector>
+
+#include "integrator.h"
+#include "blockmatrix.h"
+
+// Euler implicito (backward Euler) linearizado, no estilo de Baraff e
+// Witkin. A variacao de velocidade do passo resolve
+//   (M - h D - h^2 K) dv = h (f + h K v)
+// onde K e D sao os jacobianos das forcas das molas em relacao a posicao e
+// a velocidade. O sistema e montado em Prepare, com as forcas do passo ja
+// acumuladas, e resolvido por gradientes conjugados com precondicionador de
+// Jacobi por blocos; Integrate apenas aplica dv e avanca as posicoes.
+// As forcas dos geradores entram apenas em f (tratadas de forma explicita).
+// Particulas passivas ficam fora do sistema (linha identidade, dv = 0).
+class ImplicitEuler : public Integrator
+{
+public:
+	ImplicitEuler();
+
+	// residuo relativo em que o gradiente conjugado para
+	float _tolerance;
+	int _maxIterations;
+	// iteracoes usadas no ultimo passo
+	int _iterations;
+
+	void Prepare(Simulation* simulation);
+	void Integrate(ParticleStore* store, int stage, int begin, int end);
+
+	// politica de IntegrateRange: aplica dv e avanca a posicao
+	struct Update
+	{
+		const Vector3* _deltaVelocity;
+		float _timeStep;
+		void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
+	};
+
+private:
+	// A = M - h D - h^2 K; o padrao e refeito apenas quando as molas ou o
+	// numero de particulas mudam
+	BlockMatrix _matrix;
+	int _patternVersion;
+	int _patternParticles;
+	// bloco (i, j) de cada entrada da lista de incidencia das molas
+	std::vector<int> _incidentBlock;
+
+	// por mola: h D + h^2 K (simetrico, 6 floats) e h^2 K (va - vb)
+	std::vector<float> _jacobian;
+	std::vector<Vector3> _springTerm;
+
+	// inversa dos blocos diagonais (9 floats por linha)
+	std::vector<float> _preconditioner;
+
+	std::vector<Vector3> _deltaVelocity;
+	std::vector<Vector3> _rhs;
+	std::vector<Vector3> _residual;
+	std::vector<Vector3> _search;
+	std::vector<Vector3> _product;
+	std::vector<Vector3> _preconditioned;
+	// somas parciais por bloco do escalonador, reduzidas em ordem
+	std::vector<double> _partial;
+	std::vector<double> _partial2;
+
+	void BuildPattern(Simulation* simulation);
+	void Assemble(Simulation* simulation, int begin, int end);
+	void Solve(Simulation* simulation);
+};
+
+#endif
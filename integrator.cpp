@@ -4,14 +4,28 @@
 // PUC-Rio, Set 2009
 
 #include "vector.h"
-#include "particle.h"
+#include "particlestore.h"
 #include "integrator.h"
 
 Integrator::Integrator()
 {
+	_integratorType = NONE;
 	_fixedTimeStep = 0.05f;
 }
 
-void Integrator::Integrate(Vector3 acceleration, Particle* particle)
+Integrator::~Integrator()
+{
+}
+
+int Integrator::Stages() const
+{
+	return 1;
+}
+
+void Integrator::Prepare(Simulation* simulation)
+{
+}
+
+void Integrator::Integrate(ParticleStore* store, int stage, int begin, int end)
 {
 }
\ No newline at end of file
@@ -6,20 +6,80 @@
 #ifndef INTEGRATOR_H
 #define INTEGRATOR_H
 
-struct Vector3;
-class Particle;
+#include "vector.h"
+#include "particle.h"
+#include "particlestore.h"
 
+class Simulation;
+
+// Integrador base. A simulacao chama Integrate uma vez por bloco de
+// particulas; cada integrador implementa apenas o passo de uma particula
+// (Step) e reaproveita o laco de IntegrateRange, que recebe o integrador como
+// parametro de template para que Step seja expandido em linha, sem chamada
+// virtual por particula.
+// Integradores de varios estagios (Stages() > 1) recebem o estagio em
+// Integrate; antes de cada estagio seguinte a simulacao reavalia as forcas
+// de todo o sistema no estado deixado pelo estagio anterior.
 class Integrator
 {
 public:
+	enum IntegratorType
+	{
+		NONE,
+		EULER,
+		VERLET,
+		SYMPLECTIC_EULER,
+		LEAPFROG,
+		RUNGE_KUTTA4,
+		IMPLICIT_EULER
+	};
+
 	Integrator();
+	virtual ~Integrator();
 	
-    virtual void Integrate(Vector3 acceleration, Particle* particle);
+	// Numero de avaliacoes de forca por passo
+	virtual int Stages() const;
 
-protected:
+	// Chamado uma vez por passo, antes do primeiro estagio e fora dos blocos
+	// paralelos, com as forcas do primeiro estagio ja acumuladas; ajusta os
+	// buffers de estagio ou resolve etapas globais do passo
+	virtual void Prepare(Simulation* simulation);
+
+	// Executa o estagio stage para as particulas ativas de [begin, end)
+	virtual void Integrate(ParticleStore* store, int stage, int begin, int end);
+
+	IntegratorType _integratorType;
+
+	// passo de tempo de cada chamada de Simulation::Update; o TimeStepper da
+	// simulacao o ajusta no modo adaptativo
 	float _fixedTimeStep;
 
-private:
+protected:
+	friend class Checkpoint;
+
+	template <class Policy>
+	static void IntegrateRange(const Policy& policy, ParticleStore* store, int begin, int end)
+	{
+		Vector3* position = store->_currPosition;
+		Vector3* previous = store->_prevPosition;
+		Vector3* velocity = store->_currVelocity;
+		const Vector3* force = store->_resultantForce;
+		const float* inverseMass = store->_inverseMass;
+		const Particle::ParticleType* type = store->_particleType;
+
+		for(int i = begin; i < end; i++)
+		{
+			if(type[i] == Particle::ACTIVE)
+			{
+				Vector3 acceleration;
+				acceleration.x = force[i].x * inverseMass[i];
+				acceleration.y = force[i].y * inverseMass[i];
+				acceleration.z = force[i].z * inverseMass[i];
+
+				policy.Step(i, position[i], previous[i], velocity[i], acceleration);
+			}
+		}
+	}
 };
 
 #endif
\ No newline at end of file
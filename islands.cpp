@@ -0,0 +1,290 @@
+// islands.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "profiler.h"
+#include "simulation.h"
+#include "islands.h"
+
+IslandManager::IslandManager()
+{
+	_enabled = false;
+	_sleepVelocity = 1.0f;
+	_sleepDistance = 0.1f;
+	_sleepTime = 1.0f;
+
+	_islandCount = 0;
+	_sleepingCount = 0;
+}
+
+int IslandManager::Find(int particle)
+{
+	int root = particle;
+	while(_parent[root] != root)
+		root = _parent[root];
+
+	// compressao do caminho
+	while(_parent[particle] != root)
+	{
+		int next = _parent[particle];
+		_parent[particle] = root;
+		particle = next;
+	}
+	return root;
+}
+
+void IslandManager::Union(int particleA, int particleB)
+{
+	int rootA = Find(particleA);
+	int rootB = Find(particleB);
+	if(rootA == rootB)
+		return;
+
+	// a raiz de menor indice permanece, o que torna a numeracao estavel
+	if(rootA < rootB)
+		_parent[rootB] = rootA;
+	else
+		_parent[rootA] = rootB;
+}
+
+void IslandManager::WakeParticle(ParticleStore* store, int particle)
+{
+	if(store->_particleType[particle] != Particle::SLEEPING)
+		return;
+
+	// a contagem de repouso e mantida: se a particula acordada nao chegar a
+	// se mover, volta a dormir assim que a ilha ficar em repouso
+	store->_particleType[particle] = Particle::ACTIVE;
+	// as molas continuam somando forcas nas particulas adormecidas
+	store->_resultantForce[particle] = Vector3(0.0f, 0.0f, 0.0f);
+}
+
+bool IslandManager::Resting(int particle) const
+{
+	return particle < (int)_restTime.size() && _restTime[particle] >= _sleepTime;
+}
+
+void IslandManager::Wake(ParticleStore* store, int particle)
+{
+	if(particle >= (int)_island.size() || _island[particle] < 0)
+	{
+		WakeParticle(store, particle);
+		return;
+	}
+
+	int island = _island[particle];
+	for(int k = _islandStart[island]; k < _islandStart[island + 1]; k++)
+		WakeParticle(store, _islandMembers[k]);
+}
+
+void IslandManager::Remap(const int* order, const int* newIndex, int count)
+{
+	// particulas inseridas desde o ultimo Update comecam sem repouso
+	_restTime.resize(count, 0.0f);
+	_restPosition.resize(count, Vector3(0.0f, 0.0f, 0.0f));
+	_island.resize(count, -1);
+
+	std::vector<float> restTime(_restTime);
+	std::vector<Vector3> restPosition(_restPosition);
+	std::vector<int> island(_island);
+	for(int i = 0; i < count; i++)
+	{
+		_restTime[i] = restTime[order[i]];
+		_restPosition[i] = restPosition[order[i]];
+		_island[i] = island[order[i]];
+	}
+	for(int k = 0; k < (int)_islandMembers.size(); k++)
+		_islandMembers[k] = newIndex[_islandMembers[k]];
+}
+
+void IslandManager::RemoveParticle(ParticleStore* store, int particle, int moved)
+{
+	// a ultima posicao (moved, ou a propria particula) deixa de existir
+	int count = (int)_restTime.size();
+	if(moved >= 0 && particle < count)
+	{
+		if(moved < count)
+		{
+			_restTime[particle] = _restTime[moved];
+			_restPosition[particle] = _restPosition[moved];
+		}
+		else
+		{
+			// inserida depois do ultimo Update
+			_restTime[particle] = 0.0f;
+			_restPosition[particle] = store->_currPosition[moved];
+		}
+	}
+	int last = moved >= 0 ? moved : particle;
+	if(last < count)
+	{
+		_restTime.resize(last);
+		_restPosition.resize(last);
+	}
+
+	// Wake passa a acordar apenas a propria particula ate o proximo Update
+	_island.clear();
+	_islandStart.clear();
+	_islandMembers.clear();
+}
+
+void IslandManager::BuildMembers()
+{
+	int count = (int)_island.size();
+
+	_islandStart.assign(_islandCount + 1, 0);
+	for(int i = 0; i < count; i++)
+	{
+		if(_island[i] >= 0)
+			_islandStart[_island[i] + 1]++;
+	}
+	for(int k = 0; k < _islandCount; k++)
+		_islandStart[k + 1] += _islandStart[k];
+
+	// _parent ja nao e usado e serve de cursor de preenchimento
+	_islandMembers.resize(_islandStart[_islandCount]);
+	std::vector<int>& fill = _parent;
+	fill.resize(count);
+	for(int k = 0; k < _islandCount; k++)
+		fill[k] = _islandStart[k];
+	for(int i = 0; i < count; i++)
+	{
+		if(_island[i] >= 0)
+			_islandMembers[fill[_island[i]]++] = i;
+	}
+}
+
+void IslandManager::Update(Simulation* simulation)
+{
+	PROFILE_ZONE("IslandManager::Update", 0);
+
+	ParticleStore* store = &simulation->_store;
+	int count = store->_count;
+	Particle::ParticleType* type = store->_particleType;
+	Vector3* position = store->_currPosition;
+
+	int previous = (int)_restTime.size();
+	_restTime.resize(count, 0.0f);
+	_restPosition.resize(count);
+	for(int i = previous; i < count; i++)
+		_restPosition[i] = position[i];
+
+	// tempo em repouso de cada particula ativa
+	float sleepVelocity2 = _sleepVelocity * _sleepVelocity;
+	float sleepDistance2 = _sleepDistance * _sleepDistance;
+	float sleepTime = _sleepTime;
+	float timeStep = simulation->_integrator->_fixedTimeStep;
+	simulation->_scheduler.ParallelFor(0, count, simulation->_chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("IslandManager::Rest", thread);
+		const Vector3* velocity = store->_currVelocity;
+
+		for(int i = begin; i < end; i++)
+		{
+			if(type[i] != Particle::ACTIVE)
+				continue;
+
+			Vector3 drift = position[i];
+			drift -= _restPosition[i];
+			if(velocity[i].SqrLength() <= sleepVelocity2 && drift.SqrLength() <= sleepDistance2)
+			{
+				if(_restTime[i] < sleepTime)
+					_restTime[i] += timeStep;
+			}
+			else
+			{
+				_restTime[i] = 0.0f;
+				_restPosition[i] = position[i];
+			}
+		}
+	});
+
+	// ilhas: molas, restricoes e contatos entre particulas nao passivas
+	_parent.resize(count);
+	for(int i = 0; i < count; i++)
+		_parent[i] = i;
+
+	SpringTable& springs = simulation->_springs;
+	for(int s = 0; s < springs._count; s++)
+	{
+		int a = springs._particleA[s];
+		int b = springs._particleB[s];
+		if(type[a] != Particle::PASSIVE && type[b] != Particle::PASSIVE)
+			Union(a, b);
+	}
+
+	ConstraintTable& constraints = simulation->_constraints;
+	for(int c = 0; c < constraints._count; c++)
+	{
+		int a = constraints._particleA[c];
+		int b = constraints._particleB[c];
+		if(type[a] != Particle::PASSIVE && type[b] != Particle::PASSIVE)
+			Union(a, b);
+	}
+
+	// um contato so liga ilhas se uma das particulas ainda se move; contatos
+	// entre particulas em repouso nao propagam movimento, e sem isso uma
+	// pilha inteira so dormiria se todas as particulas parassem juntas
+	int pairs = (int)simulation->_contacts.size();
+	for(int k = 0; k < pairs; k++)
+	{
+		if(!simulation->_contacts[k])
+			continue;
+
+		int a = simulation->_pairs[2*k];
+		int b = simulation->_pairs[2*k+1];
+		if(type[a] == Particle::PASSIVE || type[b] == Particle::PASSIVE)
+			continue;
+		if(!Resting(a) || !Resting(b))
+			Union(a, b);
+	}
+
+	// numeracao das ilhas na ordem das particulas
+	_island.assign(count, -1);
+	_islandCount = 0;
+	for(int i = 0; i < count; i++)
+	{
+		if(type[i] == Particle::PASSIVE)
+			continue;
+
+		int root = Find(i);
+		if(_island[root] < 0)
+			_island[root] = _islandCount++;
+		_island[i] = _island[root];
+	}
+
+	// particulas de cada ilha e ilhas prontas para dormir
+	BuildMembers();
+	_islandReady.assign(_islandCount, 1);
+	for(int i = 0; i < count; i++)
+	{
+		int island = _island[i];
+		if(island >= 0 && type[i] == Particle::ACTIVE && _restTime[i] < sleepTime)
+			_islandReady[island] = 0;
+	}
+
+	// uma ilha dorme inteira; uma ilha com particulas acordadas que ainda se
+	// movem (por exemplo, ligada por contato a uma ilha adormecida) acorda
+	_sleepingCount = 0;
+	for(int k = 0; k < _islandCount; k++)
+	{
+		for(int m = _islandStart[k]; m < _islandStart[k + 1]; m++)
+		{
+			int i = _islandMembers[m];
+			if(!_islandReady[k])
+			{
+				WakeParticle(store, i);
+				continue;
+			}
+
+			if(type[i] == Particle::ACTIVE)
+			{
+				type[i] = Particle::SLEEPING;
+				store->_currVelocity[i] = Vector3(0.0f, 0.0f, 0.0f);
+				store->_prevPosition[i] = position[i];
+			}
+			_sleepingCount++;
+		}
+	}
+}
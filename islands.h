@@ -0,0 +1,80 @@
+// islands.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef ISLANDS_H
+#define ISLANDS_H
+
+#include <vector>
+
+#include "vector.h"
+
+class Simulation;
+class ParticleStore;
+
+// Deteccao de repouso por ilhas. Uma ilha e um conjunto de particulas
+// ligadas por molas, restricoes ou contatos do passo, montado com
+// union-find; particulas passivas nao ligam ilhas, pois nao se movem.
+// Cada particula ativa acumula o tempo seguido em que a velocidade fica
+// abaixo de _sleepVelocity e a posicao nao se afasta mais que _sleepDistance
+// do ponto em que a contagem comecou. A janela e medida em tempo, e nao em
+// passos, para que o criterio nao dependa do passo (com passos curtos uma
+// particula parada no alto de uma queda atenderia a qualquer janela de
+// poucos passos). Quando todas as particulas de uma ilha passam de
+// _sleepTime, a ilha inteira dorme: as particulas passam a
+// Particle::SLEEPING, com velocidade nula, e deixam de ser integradas e
+// testadas contra os planos. O contato de uma particula ativa que ainda se
+// move com uma adormecida acorda a ilha da adormecida (Wake).
+// Contatos entre particulas em repouso nao ligam ilhas, de modo que uma
+// pilha adormece por partes enquanto outras partes ainda se acomodam.
+class IslandManager
+{
+public:
+	IslandManager();
+
+	bool _enabled;
+	float _sleepVelocity;
+	float _sleepDistance;
+	float _sleepTime;
+
+	// estatisticas do ultimo Update
+	int _islandCount;
+	int _sleepingCount;
+
+	// Atualiza a deteccao de repouso e as ilhas; chamado ao fim de cada passo
+	void Update(Simulation* simulation);
+
+	// Particula parada ha pelo menos _sleepTime (ou adormecida)
+	bool Resting(int particle) const;
+
+	// Acorda a ilha a que a particula pertencia no ultimo Update
+	void Wake(ParticleStore* store, int particle);
+
+	// Acompanha ParticleStore::Permute (order e newIndex sao inversas)
+	void Remap(const int* order, const int* newIndex, int count);
+	// Acompanha ParticleStore::Remove (chamado antes dele); as ilhas sao
+	// refeitas no proximo Update
+	void RemoveParticle(ParticleStore* store, int particle, int moved);
+
+private:
+	friend class Checkpoint;
+
+	std::vector<int> _parent;
+	std::vector<float> _restTime;
+	std::vector<Vector3> _restPosition;
+
+	// ilha de cada particula (-1 para passivas) e particulas de cada ilha
+	std::vector<int> _island;
+	std::vector<int> _islandStart;
+	std::vector<int> _islandMembers;
+	std::vector<unsigned char> _islandReady;
+
+	int Find(int particle);
+	// Refaz _islandStart e _islandMembers a partir de _island
+	void BuildMembers();
+	void Union(int particleA, int particleB);
+	void WakeParticle(ParticleStore* store, int particle);
+};
+
+#endif
@@ -0,0 +1,55 @@
+// leapfrog.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "vector.h"
+#include "particlestore.h"
+#include "leapfrog.h"
+
+Leapfrog::Leapfrog()
+{
+	_integratorType = LEAPFROG;
+}
+
+int Leapfrog::Stages() const
+{
+	return 2;
+}
+
+inline void Leapfrog::KickDrift::Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const
+{
+	velocity.x += acceleration.x * _halfStep;
+	velocity.y += acceleration.y * _halfStep;
+	velocity.z += acceleration.z * _halfStep;
+
+	previous = position;
+
+	position.x += velocity.x * _timeStep;
+	position.y += velocity.y * _timeStep;
+	position.z += velocity.z * _timeStep;
+}
+
+inline void Leapfrog::Kick::Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const
+{
+	velocity.x += acceleration.x * _halfStep;
+	velocity.y += acceleration.y * _halfStep;
+	velocity.z += acceleration.z * _halfStep;
+}
+
+void Leapfrog::Integrate(ParticleStore* store, int stage, int begin, int end)
+{
+	if(stage == 0)
+	{
+		KickDrift kickDrift;
+		kickDrift._halfStep = 0.5f * _fixedTimeStep;
+		kickDrift._timeStep = _fixedTimeStep;
+		IntegrateRange(kickDrift, store, begin, end);
+	}
+	else
+	{
+		Kick kick;
+		kick._halfStep = 0.5f * _fixedTimeStep;
+		IntegrateRange(kick, store, begin, end);
+	}
+}
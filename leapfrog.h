@@ -0,0 +1,38 @@
+// leapfrog.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef LEAPFROG_H
+#define LEAPFROG_H
+
+#include "integrator.h"
+
+// Leapfrog na forma kick-drift-kick (Verlet de velocidade), de segunda ordem
+// e simpletico. Usa dois estagios por passo:
+//   0: meio impulso na velocidade e deslocamento da posicao por um passo
+//   1: meio impulso com as forcas avaliadas na nova posicao
+class Leapfrog : public Integrator
+{
+public:
+	Leapfrog();
+
+	int Stages() const;
+	void Integrate(ParticleStore* store, int stage, int begin, int end);
+
+	// politicas de cada estagio para IntegrateRange
+	struct KickDrift
+	{
+		float _halfStep;
+		float _timeStep;
+		void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
+	};
+
+	struct Kick
+	{
+		float _halfStep;
+		void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
+	};
+};
+
+#endif
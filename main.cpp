@@ -11,143 +11,38 @@
 #include "GL/gl.h"
 #include "glut.h"
 
+#include "scene.h"
 #include "graphics.h"
-#include "gravity.h"
-#include "medium.h"
 #include "simulation.h"
 
 Simulation* mySim = new Simulation();
 
 static void Initialize()
 {
-	Particle::ParticleType passive = Particle::ParticleType::PASSIVE;
-	Particle::ParticleType active = Particle::ParticleType::ACTIVE;
-
-	//
-	// Criando caixa a partir de planos
-	//
-	float size = 3.0f;
-
-	float planeR = 0.5f;
-	float planeG = 0.5f;
-	float planeB = 0.5f;
-
-	// Plane Bottom
-	Vector3 normal0 = Vector3(0.0f, 1.0f, 0.0f);
-	Vector3 position0 = Vector3(0.0f, 0.0f, 0.0f);
-
-	Plane* plane0 = new Plane();
-	plane0->Initialize(size, normal0, position0, planeR, planeG, planeB);
-	mySim->AddPlane(plane0);
-
-	// Plane Right
-	Vector3 normal1 = Vector3(-1.0f, 0.0f, 0.0f);
-	Vector3 position1 = Vector3(size, size, 0.0f);
-
-	Plane* plane1 = new Plane();
-	plane1->Initialize(size, normal1, position1, planeR, planeG, planeB);
-	mySim->AddPlane(plane1);
-
-	// Plane Left
-	Vector3 normal2 = Vector3(1.0f, 0.0f, 0.0f);
-	Vector3 position2 = Vector3(-size, size, 0.0f);
-
-	Plane* plane2 = new Plane();
-	plane2->Initialize(size, normal2, position2, planeR, planeG, planeB);
-	mySim->AddPlane(plane2);
-
-	// Plane Front
-	Vector3 normal3 = Vector3(0.0f, 0.0f, -1.0f);
-	Vector3 position3 = Vector3(0.0f, size, size);
-
-	Plane* plane3 = new Plane();
-	plane3->Initialize(size, normal3, position3, planeR, planeG, planeB);
-	mySim->AddPlane(plane3);
-
-	// Plane Back
-	Vector3 normal4 = Vector3(0.0f, 0.0f, 1.0f);
-	Vector3 position4 = Vector3(0.0f, size, -size);
-
-	Plane* plane4 = new Plane();
-	plane4->Initialize(size, normal4, position4, planeR, planeG, planeB);
-	mySim->AddPlane(plane4);
-
-	// Particle Generator
-	float genMass = 10.0f;
-	float genRadius = 0.5f;
-	int genMax = 250;
-	float genX = 0.0f;
-	float genY = 25.0f;
-	float genZ = 0.0f;
-
-	ParticleGenerator* generator = new ParticleGenerator();
-	generator->Initialize(genMass, genRadius, genMax, genX, genY, genZ);
-	mySim->AddParticleGenerator(generator);
-
-// 	// Particle
-// 	float particleMass = 100.0f;
-// 	float particleRadius = 2.5f;
-// 	float particleX = 0.0f;
-// 	float particleY = 2.5f;
-// 	float particleZ = 0.0f;
-// 	float particleR = 1.0f;
-// 	float particleG = 0.0f;
-// 	float particleB = 0.0f;
-// 
-// 	Particle* particle = new Particle();
-// 	particle->Initialize(particleMass, particleRadius, particleX, particleY, particleZ, particleR, particleG, particleB, passive);
-// 	mySim->AddParticle(particle);
-
-// 	// Cube
-// 	float cubeMass = 2.0f;
-// 	float cubeRadius = 0.1f;
-// 	float xMin = -2.0f;
-// 	float xMax = +0.0f;
-// 	float yMin = 13.0f;
-// 	float yMax = 15.0f;
-// 	float zMin = -1.0f;
-// 	float zMax = +1.0f;
-// 	float cubeR = 0.0f;
-// 	float cubeG = 1.0f;
-// 	float cubeB = 0.0f;
-// 
-// 	Cube* cube = new Cube();
-// 	cube->Initialize(cubeMass, cubeRadius, xMin, xMax, yMin, yMax, zMin, zMax, cubeR, cubeG, cubeB, active);
-// 	mySim->AddCube(cube);
-
-// 	// Cloth
-// 	float clothMass = 100.0f;
-// 	float clothRadius = 0.1f;
-// 	int nU = 15;
-// 	int nV = 15;
-// 	Vector3 p = Vector3(3.0f, 15.0f, 3.0f);
-// 	Vector3 pU = Vector3(-3.0f, 15.0f, 3.0f);
-// 	Vector3 pV = Vector3(3.0f, 15.0f, -3.0f);
-// 	float clothR = 0.0f;
-// 	float clothG = 0.0f;
-// 	float clothB = 1.0f;
-// 
-// 	Cloth* cloth = new Cloth();
-// 	cloth->Initialize(clothMass, clothRadius, nU, nV, p, pU, pV, clothR, clothG, clothB, active);
-// 	mySim->AddCloth(cloth);
-
-	Gravity* gravity = new Gravity();
-	mySim->AddForceGenerator((ForceGenerator*)gravity);
-
-	/*Medium* air = new Medium(0.50f);
-	mySim->AddForceGenerator((ForceGenerator*)air);*/
-
-	Euler* integrator = new Euler();
-	mySim->_integrator = (Integrator*)integrator;
-
-	/*Verlet* integrator = new Verlet();
-	mySim->_integrator = (Integrator*)integrator;*/
+	// cenas disponiveis: "rain", "fountain", "cube", "cloth", "drape", "bowl" e "terrain" (ver scene.cpp)
+	Scene::Load(mySim, "rain");
+
+	// distribui as fases da simulacao entre os nucleos disponiveis
+	mySim->_scheduler.Initialize((int)std::thread::hardware_concurrency());
+
+	// passo ajustado pelo erro local estimado (ver timestepper.h)
+	mySim->_stepper._adaptive = true;
+	// ilhas em repouso deixam de ser integradas (ver islands.h)
+	mySim->_islands._enabled = true;
+	// particulas vizinhas no espaco ficam vizinhas na memoria (ver mortonorder.h)
+	mySim->_morton._enabled = true;
 }
 
+static int s_lastTime = -1;
+
 static void Update()
 {
-	//for(int i = 0; i < 10; i++)
-		mySim->Update();
+	// avanca a simulacao pelo tempo real decorrido desde o quadro anterior
+	int now = glutGet(GLUT_ELAPSED_TIME);
+	float elapsed = s_lastTime < 0 ? 0.0f : 0.001f * (now - s_lastTime);
+	s_lastTime = now;
+
+	mySim->Advance(elapsed);
 }
 
 static void Draw()
@@ -4,11 +4,13 @@
 // PUC-Rio, Set 2009
 
 #include "vector.h"
-#include "particle.h"
+#include "particlestore.h"
 #include "medium.h"
 
 Medium::Medium()
 {
+	_forceGeneratorType = MEDIUM;
+	_dragCoefficient = 0.0f;
 }
 
 Medium::~Medium()
@@ -17,12 +19,22 @@ Medium::~Medium()
 
 Medium::Medium(float dragCoefficient)
 {
+	_forceGeneratorType = MEDIUM;
 	_dragCoefficient = dragCoefficient;
 }
 
-void Medium::ApplyForce(Particle* particle)
+void Medium::ApplyForce(ParticleStore* store, int begin, int end)
 {
-	particle->_resultantForce.x += -_dragCoefficient * particle->_currVelocity.x;
-	particle->_resultantForce.y += -_dragCoefficient * particle->_currVelocity.y;
-	particle->_resultantForce.z += -_dragCoefficient * particle->_currVelocity.z;
+	Vector3* force = store->_resultantForce;
+	Vector3* velocity = store->_currVelocity;
+
+	for(int i = begin; i < end; i++)
+	{
+		if(store->_particleType[i] == Particle::ParticleType::ACTIVE)
+		{
+			force[i].x += -_dragCoefficient * velocity[i].x;
+			force[i].y += -_dragCoefficient * velocity[i].y;
+			force[i].z += -_dragCoefficient * velocity[i].z;
+		}
+	}
 }
\ No newline at end of file
@@ -18,7 +18,7 @@ public:
 
 	float _dragCoefficient;
 
-	void ApplyForce(Particle* particle);
+	void ApplyForce(ParticleStore* store, int begin, int end);
 };
 
 #endif
\ No newline at end of file
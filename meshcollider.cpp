@@ -0,0 +1,896 @@
+// meshcollider.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "graphics.h"
+
+#include "simd.h"
+#include "meshfile.h"
+#include "particlestore.h"
+#include "meshcollider.h"
+
+static const char MESH_MAGIC[8] = { 'S', 'I', 'M', 'F', 'B', 'V', 'H', 0 };
+static const int MESH_VERSION = 1;
+
+// triangulos por folha: um pacote
+static const int LEAF_SIZE = 4;
+// faixas por eixo na avaliacao da SAH
+static const int BINS = 16;
+// profundidade a partir da qual a divisao passa a ser pela mediana
+static const int MAX_SAH_DEPTH = 48;
+// profundidade maxima aceita, e tamanho da pilha da busca
+static const int MESH_STACK = 128;
+
+struct MeshTriangle
+{
+	Vector3 _a, _b, _c;
+	float _min[3];
+	float _max[3];
+	float _center[3];
+};
+
+struct MeshBin
+{
+	float _min[3];
+	float _max[3];
+	int _count;
+};
+
+static inline void Clear(float* lo, float* hi)
+{
+	for(int a = 0; a < 3; a++)
+	{
+		lo[a] = FLT_MAX;
+		hi[a] = -FLT_MAX;
+	}
+}
+
+static inline void Grow(float* lo, float* hi, const float* boxLo, const float* boxHi)
+{
+	for(int a = 0; a < 3; a++)
+	{
+		if(boxLo[a] < lo[a])
+			lo[a] = boxLo[a];
+		if(boxHi[a] > hi[a])
+			hi[a] = boxHi[a];
+	}
+}
+
+static inline int Bin(float value, float origin, float scale)
+{
+	float t = (value - origin) * scale;
+	if(!(t > 0.0f))
+		return 0;
+	return t < BINS - 1 ? (int)t : BINS - 1;
+}
+
+static inline float Area(const float* lo, const float* hi)
+{
+	float dx = hi[0] - lo[0];
+	float dy = hi[1] - lo[1];
+	float dz = hi[2] - lo[2];
+	return dx * dy + dy * dz + dz * dx;
+}
+
+// Construcao de cima para baixo: cada no e emitido antes das suas
+// subarvores, e o salto e preenchido quando a subarvore termina
+class MeshBuilder
+{
+public:
+	std::vector<MeshTriangle> _triangles;
+	std::vector<MeshNode> _nodes;
+	std::vector<MeshPacket> _packets;
+
+	void Build(int begin, int end, int depth)
+	{
+		int node = (int)_nodes.size();
+		_nodes.push_back(MeshNode());
+		MeshNode& box = _nodes[node];
+		Clear(box._min, box._max);
+		for(int k = begin; k < end; k++)
+		{
+			Grow(box._min, box._max, _triangles[k]._min, _triangles[k]._max);
+		}
+
+		if(end - begin <= LEAF_SIZE)
+		{
+			box._packet = (int)_packets.size();
+			box._skip = node + 1;
+			AddPacket(begin, end);
+			return;
+		}
+
+		box._packet = -1;
+		int split = depth < MAX_SAH_DEPTH ? Split(begin, end) : -1;
+		if(split < 0)
+			split = Median(begin, end);
+		Build(begin, split, depth + 1);
+		Build(split, end, depth + 1);
+		_nodes[node]._skip = (int)_nodes.size();
+	}
+
+private:
+	int Split(int begin, int end)
+	{
+		float lo[3], hi[3];
+		Clear(lo, hi);
+		for(int k = begin; k < end; k++)
+		{
+			Grow(lo, hi, _triangles[k]._center, _triangles[k]._center);
+		}
+
+		int bestAxis = -1;
+		int bestBin = 0;
+		float bestCost = FLT_MAX;
+		for(int axis = 0; axis < 3; axis++)
+		{
+			float extent = hi[axis] - lo[axis];
+			if(extent <= 0.0f)
+				continue;
+			float scale = BINS / extent;
+
+			MeshBin bins[BINS];
+			for(int k = 0; k < BINS; k++)
+			{
+				Clear(bins[k]._min, bins[k]._max);
+				bins[k]._count = 0;
+			}
+			for(int k = begin; k < end; k++)
+			{
+				const MeshTriangle& triangle = _triangles[k];
+				int bin = Bin(triangle._center[axis], lo[axis], scale);
+				Grow(bins[bin]._min, bins[bin]._max, triangle._min, triangle._max);
+				bins[bin]._count++;
+			}
+
+			float rightArea[BINS];
+			int rightCount[BINS];
+			float boxLo[3], boxHi[3];
+			Clear(boxLo, boxHi);
+			int count = 0;
+			for(int k = BINS - 1; k > 0; k--)
+			{
+				Grow(boxLo, boxHi, bins[k]._min, bins[k]._max);
+				count += bins[k]._count;
+				rightArea[k] = count > 0 ? Area(boxLo, boxHi) : 0.0f;
+				rightCount[k] = count;
+			}
+
+			Clear(boxLo, boxHi);
+			count = 0;
+			for(int k = 1; k < BINS; k++)
+			{
+				Grow(boxLo, boxHi, bins[k-1]._min, bins[k-1]._max);
+				count += bins[k-1]._count;
+				if(count == 0 || rightCount[k] == 0)
+					continue;
+
+				float cost = count * Area(boxLo, boxHi) + rightCount[k] * rightArea[k];
+				if(cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = k;
+				}
+			}
+		}
+
+		if(bestAxis < 0)
+			return -1;
+
+		float origin = lo[bestAxis];
+		float scale = BINS / (hi[bestAxis] - lo[bestAxis]);
+		std::vector<MeshTriangle>::iterator middle = std::partition(_triangles.begin() + begin, _triangles.begin() + end, [&](const MeshTriangle& triangle)
+		{
+			return Bin(triangle._center[bestAxis], origin, scale) < bestBin;
+		});
+		return (int)(middle - _triangles.begin());
+	}
+
+	// divide ao meio no eixo de maior extensao dos centros
+	int Median(int begin, int end)
+	{
+		float lo[3], hi[3];
+		Clear(lo, hi);
+		for(int k = begin; k < end; k++)
+		{
+			Grow(lo, hi, _triangles[k]._center, _triangles[k]._center);
+		}
+		int axis = 0;
+		for(int a = 1; a < 3; a++)
+		{
+			if(hi[a] - lo[a] > hi[axis] - lo[axis])
+				axis = a;
+		}
+
+		int middle = begin + (end - begin) / 2;
+		std::nth_element(_triangles.begin() + begin, _triangles.begin() + middle, _triangles.begin() + end, [&](const MeshTriangle& p, const MeshTriangle& q)
+		{
+			return p._center[axis] < q._center[axis];
+		});
+		return middle;
+	}
+
+	void AddPacket(int begin, int end)
+	{
+		MeshPacket packet;
+		for(int k = 0; k < 4; k++)
+		{
+			int t = begin + k < end ? begin + k : end - 1;
+			const MeshTriangle& triangle = _triangles[t];
+			const Vector3* corner[3] = { &triangle._a, &triangle._b, &triangle._c };
+
+			Vector3 ab = triangle._b;
+			ab -= triangle._a;
+			Vector3 ac = triangle._c;
+			ac -= triangle._a;
+			Vector3 n = Cross(ab, ac);
+			n.Normalize();
+
+			for(int a = 0; a < 3; a++)
+			{
+				packet._a[a][k] = (&triangle._a.x)[a];
+				packet._b[a][k] = (&triangle._b.x)[a];
+				packet._c[a][k] = (&triangle._c.x)[a];
+				packet._n[a][k] = (&n.x)[a];
+			}
+			for(int e = 0; e < 3; e++)
+			{
+				Vector3 edge = *corner[(e + 1) % 3];
+				edge -= *corner[e];
+				packet._inverse[e][k] = 1.0f / edge.SqrLength();
+			}
+			packet._valid[k] = begin + k < end ? 1.0f : 0.0f;
+		}
+		_packets.push_back(packet);
+	}
+};
+
+// Distancia ao quadrado do centro c ao triangulo k do pacote, com a
+// diferenca entre c e o ponto mais proximo, e distancia ao plano do
+// triangulo, negativa apenas quando c esta atras da face e a sua projecao cai
+// dentro do triangulo. TestPacket faz as mesmas operacoes nos 4 triangulos
+// de uma vez, com o mesmo resultado.
+static inline void TestTriangle(const MeshPacket& p, int k, const float* c, float& height, float& distance2, float* diff)
+{
+	float ax = p._a[0][k], ay = p._a[1][k], az = p._a[2][k];
+	float bx = p._b[0][k], by = p._b[1][k], bz = p._b[2][k];
+	float cx = p._c[0][k], cy = p._c[1][k], cz = p._c[2][k];
+	float nx = p._n[0][k], ny = p._n[1][k], nz = p._n[2][k];
+
+	float pax = c[0] - ax, pay = c[1] - ay, paz = c[2] - az;
+	float pbx = c[0] - bx, pby = c[1] - by, pbz = c[2] - bz;
+	float pcx = c[0] - cx, pcy = c[1] - cy, pcz = c[2] - cz;
+	float abx = bx - ax, aby = by - ay, abz = bz - az;
+	float bcx = cx - bx, bcy = cy - by, bcz = cz - bz;
+	float cax = ax - cx, cay = ay - cy, caz = az - cz;
+
+	float plane = pax * nx + pay * ny + paz * nz;
+	height = plane;
+
+	// projecao dentro do triangulo: c esta do lado interno das tres arestas
+	float wab = (aby * paz - abz * pay) * nx + (abz * pax - abx * paz) * ny + (abx * pay - aby * pax) * nz;
+	float wbc = (bcy * pbz - bcz * pby) * nx + (bcz * pbx - bcx * pbz) * ny + (bcx * pby - bcy * pbx) * nz;
+	float wca = (cay * pcz - caz * pcy) * nx + (caz * pcx - cax * pcz) * ny + (cax * pcy - cay * pcx) * nz;
+	if(wab >= 0.0f && wbc >= 0.0f && wca >= 0.0f)
+	{
+		distance2 = plane * plane;
+		diff[0] = plane * nx;
+		diff[1] = plane * ny;
+		diff[2] = plane * nz;
+		return;
+	}
+
+	// senao, o ponto mais proximo das tres arestas
+	height = fabsf(plane);
+	float t = (pax * abx + pay * aby + paz * abz) * p._inverse[0][k];
+	t = t > 0.0f ? t : 0.0f;
+	t = t < 1.0f ? t : 1.0f;
+	float dx = pax - t * abx, dy = pay - t * aby, dz = paz - t * abz;
+	float d2 = dx * dx + dy * dy + dz * dz;
+
+	t = (pbx * bcx + pby * bcy + pbz * bcz) * p._inverse[1][k];
+	t = t > 0.0f ? t : 0.0f;
+	t = t < 1.0f ? t : 1.0f;
+	float ex = pbx - t * bcx, ey = pby - t * bcy, ez = pbz - t * bcz;
+	float e2 = ex * ex + ey * ey + ez * ez;
+	if(e2 < d2)
+	{
+		d2 = e2;
+		dx = ex;
+		dy = ey;
+		dz = ez;
+	}
+
+	t = (pcx * cax + pcy * cay + pcz * caz) * p._inverse[2][k];
+	t = t > 0.0f ? t : 0.0f;
+	t = t < 1.0f ? t : 1.0f;
+	ex = pcx - t * cax;
+	ey = pcy - t * cay;
+	ez = pcz - t * caz;
+	e2 = ex * ex + ey * ey + ez * ez;
+	if(e2 < d2)
+	{
+		d2 = e2;
+		dx = ex;
+		dy = ey;
+		dz = ez;
+	}
+
+	distance2 = d2;
+	diff[0] = dx;
+	diff[1] = dy;
+	diff[2] = dz;
+}
+
+// Distancia ao quadrado do ponto c a caixa do no (zero dentro dela)
+static inline float BoxDistance(const MeshNode& node, const float* c)
+{
+	float d2 = 0.0f;
+	for(int a = 0; a < 3; a++)
+	{
+		float below = node._min[a] - c[a];
+		float above = c[a] - node._max[a];
+		float d = below > above ? below : above;
+		if(d > 0.0f)
+			d2 += d * d;
+	}
+	return d2;
+}
+
+#ifdef SIMD_SSE
+static inline __m128 Clamp01(__m128 t)
+{
+	return _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+static inline __m128 Dot3(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+// (e x p) . n
+static inline __m128 CrossDot(__m128 ex, __m128 ey, __m128 ez, __m128 px, __m128 py, __m128 pz, __m128 nx, __m128 ny, __m128 nz)
+{
+	return _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ey, pz), _mm_mul_ps(ez, py)), nx),
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ez, px), _mm_mul_ps(ex, pz)), ny)),
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ex, py), _mm_mul_ps(ey, px)), nz));
+}
+
+// Aresta de origem o e vetor e com o centro em p = c - o: distancia ao
+// quadrado ao ponto mais proximo e a diferenca
+static inline __m128 EdgeDistance(__m128 px, __m128 py, __m128 pz, __m128 ex, __m128 ey, __m128 ez, __m128 inverse, __m128& dx, __m128& dy, __m128& dz)
+{
+	__m128 t = Clamp01(_mm_mul_ps(Dot3(px, py, pz, ex, ey, ez), inverse));
+	dx = _mm_sub_ps(px, _mm_mul_ps(t, ex));
+	dy = _mm_sub_ps(py, _mm_mul_ps(t, ey));
+	dz = _mm_sub_ps(pz, _mm_mul_ps(t, ez));
+	return Dot3(dx, dy, dz, dx, dy, dz);
+}
+
+// TestTriangle nos 4 triangulos do pacote; retorna false sem calcular as
+// arestas quando nenhum plano esta mais perto que limit2
+static inline bool TestPacket(const MeshPacket& p, __m128 cx, __m128 cy, __m128 cz, __m128 limit2, float* height, float* distance2, float (*diff)[4])
+{
+	__m128 ax = _mm_loadu_ps(p._a[0]), ay = _mm_loadu_ps(p._a[1]), az = _mm_loadu_ps(p._a[2]);
+	__m128 nx = _mm_loadu_ps(p._n[0]), ny = _mm_loadu_ps(p._n[1]), nz = _mm_loadu_ps(p._n[2]);
+	__m128 pax = _mm_sub_ps(cx, ax), pay = _mm_sub_ps(cy, ay), paz = _mm_sub_ps(cz, az);
+
+	__m128 plane = Dot3(pax, pay, paz, nx, ny, nz);
+	__m128 square = _mm_mul_ps(plane, plane);
+	if(_mm_movemask_ps(_mm_cmplt_ps(square, limit2)) == 0)
+		return false;
+
+	__m128 bx = _mm_loadu_ps(p._b[0]), by = _mm_loadu_ps(p._b[1]), bz = _mm_loadu_ps(p._b[2]);
+	__m128 tx = _mm_loadu_ps(p._c[0]), ty = _mm_loadu_ps(p._c[1]), tz = _mm_loadu_ps(p._c[2]);
+	__m128 pbx = _mm_sub_ps(cx, bx), pby = _mm_sub_ps(cy, by), pbz = _mm_sub_ps(cz, bz);
+	__m128 pcx = _mm_sub_ps(cx, tx), pcy = _mm_sub_ps(cy, ty), pcz = _mm_sub_ps(cz, tz);
+	__m128 abx = _mm_sub_ps(bx, ax), aby = _mm_sub_ps(by, ay), abz = _mm_sub_ps(bz, az);
+	__m128 bcx = _mm_sub_ps(tx, bx), bcy = _mm_sub_ps(ty, by), bcz = _mm_sub_ps(tz, bz);
+	__m128 cax = _mm_sub_ps(ax, tx), cay = _mm_sub_ps(ay, ty), caz = _mm_sub_ps(az, tz);
+
+	const __m128 zero = _mm_setzero_ps();
+	__m128 inside = _mm_and_ps(_mm_and_ps(
+		_mm_cmpge_ps(CrossDot(abx, aby, abz, pax, pay, paz, nx, ny, nz), zero),
+		_mm_cmpge_ps(CrossDot(bcx, bcy, bcz, pbx, pby, pbz, nx, ny, nz), zero)),
+		_mm_cmpge_ps(CrossDot(cax, cay, caz, pcx, pcy, pcz, nx, ny, nz), zero));
+
+	__m128 dx, dy, dz, ex, ey, ez;
+	__m128 d2 = EdgeDistance(pax, pay, paz, abx, aby, abz, _mm_loadu_ps(p._inverse[0]), dx, dy, dz);
+	__m128 e2 = EdgeDistance(pbx, pby, pbz, bcx, bcy, bcz, _mm_loadu_ps(p._inverse[1]), ex, ey, ez);
+	__m128 closer = _mm_cmplt_ps(e2, d2);
+	d2 = SimdSelect(closer, e2, d2);
+	dx = SimdSelect(closer, ex, dx);
+	dy = SimdSelect(closer, ey, dy);
+	dz = SimdSelect(closer, ez, dz);
+	e2 = EdgeDistance(pcx, pcy, pcz, cax, cay, caz, _mm_loadu_ps(p._inverse[2]), ex, ey, ez);
+	closer = _mm_cmplt_ps(e2, d2);
+	d2 = SimdSelect(closer, e2, d2);
+	dx = SimdSelect(closer, ex, dx);
+	dy = SimdSelect(closer, ey, dy);
+	dz = SimdSelect(closer, ez, dz);
+
+	_mm_storeu_ps(height, SimdSelect(inside, plane, _mm_andnot_ps(_mm_set1_ps(-0.0f), plane)));
+	_mm_storeu_ps(distance2, SimdSelect(inside, square, d2));
+	_mm_storeu_ps(diff[0], SimdSelect(inside, _mm_mul_ps(plane, nx), dx));
+	_mm_storeu_ps(diff[1], SimdSelect(inside, _mm_mul_ps(plane, ny), dy));
+	_mm_storeu_ps(diff[2], SimdSelect(inside, _mm_mul_ps(plane, nz), dz));
+	return true;
+}
+#endif
+
+MeshCollider::MeshCollider()
+{
+	_thickness = 0.0f;
+	_red = _green = _blue = 0.5f;
+	_data = 0;
+	_size = 0;
+	_mapping = 0;
+}
+
+MeshCollider::~MeshCollider()
+{
+	Release();
+}
+
+void MeshCollider::Unmap()
+{
+	if(!_mapping)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(_mapping);
+#else
+	munmap(_mapping, _size);
+#endif
+	_mapping = 0;
+}
+
+void MeshCollider::Release()
+{
+	Unmap();
+	_storage.clear();
+	_data = 0;
+	_size = 0;
+	_drawCoord.clear();
+	_drawIndex.clear();
+}
+
+const MeshNode* MeshCollider::Nodes() const
+{
+	return (const MeshNode*)(_data + sizeof(MeshHeader));
+}
+
+const MeshPacket* MeshCollider::Packets() const
+{
+	return (const MeshPacket*)(_data + sizeof(MeshHeader) + NodeCount() * sizeof(MeshNode));
+}
+
+int MeshCollider::NodeCount() const
+{
+	return _data ? ((const MeshHeader*)_data)->_nodeCount : 0;
+}
+
+int MeshCollider::TriangleCount() const
+{
+	return _data ? ((const MeshHeader*)_data)->_triangleCount : 0;
+}
+
+const char* MeshCollider::Data() const
+{
+	return _data;
+}
+
+size_t MeshCollider::Size() const
+{
+	return _size;
+}
+
+void MeshCollider::Build(const std::vector<Vector3>& vertices, const std::vector<int>& indices)
+{
+	MeshBuilder builder;
+	for(int t = 0; t + 2 < (int)indices.size(); t += 3)
+	{
+		MeshTriangle triangle;
+		triangle._a = vertices[indices[t]];
+		triangle._b = vertices[indices[t+1]];
+		triangle._c = vertices[indices[t+2]];
+
+		// triangulos sem area nao tem normal
+		Vector3 ab = triangle._b;
+		ab -= triangle._a;
+		Vector3 ac = triangle._c;
+		ac -= triangle._a;
+		Vector3 bc = triangle._c;
+		bc -= triangle._b;
+		if(!(Cross(ab, ac).SqrLength() > 0.0f) || !(ab.SqrLength() > 0.0f) ||
+			!(ac.SqrLength() > 0.0f) || !(bc.SqrLength() > 0.0f))
+			continue;
+
+		const float* corner[3] = { &triangle._a.x, &triangle._b.x, &triangle._c.x };
+		Clear(triangle._min, triangle._max);
+		for(int k = 0; k < 3; k++)
+		{
+			Grow(triangle._min, triangle._max, corner[k], corner[k]);
+		}
+		for(int a = 0; a < 3; a++)
+		{
+			triangle._center[a] = 0.5f * (triangle._min[a] + triangle._max[a]);
+		}
+		builder._triangles.push_back(triangle);
+	}
+
+	int triangles = (int)builder._triangles.size();
+	if(triangles > 0)
+		builder.Build(0, triangles, 0);
+
+	MeshHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header._magic, MESH_MAGIC, sizeof(header._magic));
+	header._version = MESH_VERSION;
+	header._nodeCount = (int)builder._nodes.size();
+	header._packetCount = (int)builder._packets.size();
+	header._triangleCount = triangles;
+
+	std::vector<char> data(sizeof(MeshHeader) + builder._nodes.size() * sizeof(MeshNode) + builder._packets.size() * sizeof(MeshPacket));
+	char* p = &data[0];
+	memcpy(p, &header, sizeof(header));
+	p += sizeof(header);
+	if(!builder._nodes.empty())
+	{
+		memcpy(p, &builder._nodes[0], builder._nodes.size() * sizeof(MeshNode));
+		p += builder._nodes.size() * sizeof(MeshNode);
+		memcpy(p, &builder._packets[0], builder._packets.size() * sizeof(MeshPacket));
+	}
+
+	Release();
+	_storage.swap(data);
+	_data = &_storage[0];
+	_size = _storage.size();
+}
+
+bool MeshCollider::Load(const char* path)
+{
+	const char* dot = strrchr(path, '.');
+	if(dot && (strcmp(dot, ".bvh") == 0 || strcmp(dot, ".BVH") == 0))
+		return Map(path);
+
+	std::vector<Vector3> vertices;
+	std::vector<int> indices;
+	if(!MeshFile::Read(path, vertices, indices))
+		return false;
+	Build(vertices, indices);
+	return true;
+}
+
+bool MeshCollider::Save(const char* path) const
+{
+	if(!_data)
+		return false;
+
+	FILE* file = fopen(path, "wb");
+	if(!file)
+		return false;
+	bool ok = fwrite(_data, 1, _size, file) == _size;
+	ok = fclose(file) == 0 && ok;
+	return ok;
+}
+
+bool MeshCollider::Validate(const char* data, size_t size)
+{
+	if(size < sizeof(MeshHeader))
+		return false;
+
+	MeshHeader header;
+	memcpy(&header, data, sizeof(header));
+	if(memcmp(header._magic, MESH_MAGIC, sizeof(header._magic)) != 0 || header._version != MESH_VERSION)
+		return false;
+	if(header._nodeCount < 0 || header._packetCount < 0 || header._triangleCount < 0 ||
+		(size_t)header._triangleCount > 4 * (size_t)header._packetCount)
+		return false;
+	if(size != sizeof(MeshHeader) + (size_t)header._nodeCount * sizeof(MeshNode) + (size_t)header._packetCount * sizeof(MeshPacket))
+		return false;
+
+	// cada no interno tem os dois filhos dentro da sua subarvore, as folhas
+	// apontam pacotes e a profundidade cabe na pilha da busca
+	const char* nodes = data + sizeof(MeshHeader);
+	std::vector<int> ends;
+	for(int n = 0; n < header._nodeCount; n++)
+	{
+		MeshNode node;
+		memcpy(&node, nodes + n * sizeof(MeshNode), sizeof(node));
+		if(node._packet < -1 || node._packet >= header._packetCount)
+			return false;
+		if(node._packet >= 0 && node._skip != n + 1)
+			return false;
+		if(node._packet < 0)
+		{
+			MeshNode left, right;
+			if(n + 1 >= header._nodeCount)
+				return false;
+			memcpy(&left, nodes + (n + 1) * sizeof(MeshNode), sizeof(left));
+			if(left._skip <= n + 1 || left._skip >= node._skip || node._skip > header._nodeCount)
+				return false;
+			memcpy(&right, nodes + left._skip * sizeof(MeshNode), sizeof(right));
+			if(right._skip != node._skip)
+				return false;
+		}
+
+		while(!ends.empty() && ends.back() <= n)
+			ends.pop_back();
+		if(!ends.empty() && node._skip > ends.back())
+			return false;
+		ends.push_back(node._skip);
+		if((int)ends.size() > MESH_STACK)
+			return false;
+	}
+	if(header._nodeCount == 0)
+		return true;
+
+	// a raiz cobre todos os nos
+	MeshNode root;
+	memcpy(&root, nodes, sizeof(root));
+	return root._skip == header._nodeCount;
+}
+
+bool MeshCollider::SetData(const char* data, size_t size)
+{
+	if(!Validate(data, size))
+		return false;
+
+	Release();
+	_storage.assign(data, data + size);
+	_data = &_storage[0];
+	_size = size;
+	return true;
+}
+
+bool MeshCollider::Map(const char* path)
+{
+	void* mapping = 0;
+	size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER length;
+	if(GetFileSizeEx(file, &length) && length.QuadPart > 0)
+	{
+		// a vista continua valida depois de fechados os descritores
+		HANDLE map = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+		if(map)
+		{
+			mapping = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+			size = (size_t)length.QuadPart;
+			CloseHandle(map);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path, O_RDONLY);
+	if(file < 0)
+		return false;
+	struct stat status;
+	if(fstat(file, &status) == 0 && status.st_size > 0)
+	{
+		mapping = mmap(0, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(mapping == MAP_FAILED)
+			mapping = 0;
+		size = (size_t)status.st_size;
+	}
+	close(file);
+#endif
+
+	if(!mapping)
+		return false;
+	if(!Validate((const char*)mapping, size))
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mapping);
+#else
+		munmap(mapping, size);
+#endif
+		return false;
+	}
+
+	Release();
+	_mapping = mapping;
+	_data = (const char*)mapping;
+	_size = size;
+	return true;
+}
+
+void MeshCollider::Collide(ParticleStore* store, float dissipative, int begin, int end) const
+{
+	int count = NodeCount();
+	if(count == 0)
+		return;
+
+	const MeshNode* nodes = Nodes();
+	const MeshPacket* packets = Packets();
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+	float* radius = store->_radius;
+	Particle::ParticleType* type = store->_particleType;
+
+	for(int i = begin; i < end; i++)
+	{
+		if(type[i] == Particle::SLEEPING)
+			continue;
+
+		// a busca alcanca tambem a espessura atras das faces
+		const float* c = &position[i].x;
+		float r = radius[i];
+		float reach = r + _thickness;
+
+		// triangulo mais proximo dentro do alcance
+		float best = reach * reach;
+		float bestHeight = 0.0f;
+		int bestPacket = -1;
+		int bestLane = 0;
+		float bestDiff[3] = { 0.0f, 0.0f, 0.0f };
+
+#ifdef SIMD_SSE
+		__m128 cx = _mm_set1_ps(c[0]);
+		__m128 cy = _mm_set1_ps(c[1]);
+		__m128 cz = _mm_set1_ps(c[2]);
+		float height[4], distance2[4], diff[3][4];
+#endif
+
+		// descida pelo filho mais proximo; o outro fica na pilha e e
+		// descartado se o triangulo achado estiver mais perto que a sua caixa
+		int stack[MESH_STACK];
+		int top = 0;
+		int n = BoxDistance(nodes[0], c) < best ? 0 : -1;
+		while(n >= 0)
+		{
+			const MeshNode& node = nodes[n];
+			if(node._packet < 0)
+			{
+				int left = n + 1;
+				int right = nodes[left]._skip;
+				float leftDistance = BoxDistance(nodes[left], c);
+				float rightDistance = BoxDistance(nodes[right], c);
+				if(leftDistance < best && rightDistance < best)
+				{
+					stack[top++] = leftDistance <= rightDistance ? right : left;
+					n = leftDistance <= rightDistance ? left : right;
+					continue;
+				}
+				if(leftDistance < best || rightDistance < best)
+				{
+					n = leftDistance < best ? left : right;
+					continue;
+				}
+			}
+			else
+			{
+				const MeshPacket& packet = packets[node._packet];
+#ifdef SIMD_SSE
+				if(TestPacket(packet, cx, cy, cz, _mm_set1_ps(best), height, distance2, diff))
+				{
+					for(int k = 0; k < 4; k++)
+					{
+						if(height[k] * height[k] < best && distance2[k] < best)
+						{
+							best = distance2[k];
+							bestHeight = height[k];
+							bestPacket = node._packet;
+							bestLane = k;
+							bestDiff[0] = diff[0][k];
+							bestDiff[1] = diff[1][k];
+							bestDiff[2] = diff[2][k];
+						}
+					}
+				}
+#else
+				for(int k = 0; k < 4; k++)
+				{
+					float height, distance2, diff[3];
+					TestTriangle(packet, k, c, height, distance2, diff);
+					if(height * height < best && distance2 < best)
+					{
+						best = distance2;
+						bestHeight = height;
+						bestPacket = node._packet;
+						bestLane = k;
+						bestDiff[0] = diff[0];
+						bestDiff[1] = diff[1];
+						bestDiff[2] = diff[2];
+					}
+				}
+#endif
+			}
+
+			n = -1;
+			while(top > 0 && n < 0)
+			{
+				int next = stack[--top];
+				if(BoxDistance(nodes[next], c) < best)
+					n = next;
+			}
+		}
+
+		if(bestPacket < 0)
+			continue;
+
+		// atras da face o centro volta para a frente ao longo da normal; na
+		// frente ou junto das arestas, afasta-se do ponto mais proximo
+		const MeshPacket& packet = packets[bestPacket];
+		Vector3 normal(packet._n[0][bestLane], packet._n[1][bestLane], packet._n[2][bestLane]);
+		float depth;
+		if(bestHeight < 0.0f)
+			depth = r - bestHeight;
+		else
+		{
+			float distance = sqrtf(best);
+			if(distance >= r)
+				continue;
+			if(distance > 0.0f)
+				normal = Vector3(bestDiff[0] / distance, bestDiff[1] / distance, bestDiff[2] / distance);
+			depth = r - distance;
+		}
+
+		Vector3 t = normal;
+		t *= depth;
+		position[i] += t;
+
+		t = normal;
+		t *= Dot(velocity[i], normal);
+
+		t *= 2.0f;
+
+		velocity[i] -= t;
+
+		velocity[i] *= dissipative;
+	}
+}
+
+void MeshCollider::Draw()
+{
+	if(!_data)
+		return;
+
+	if(_drawIndex.empty())
+	{
+		const MeshPacket* packets = Packets();
+		int packetCount = ((const MeshHeader*)_data)->_packetCount;
+		for(int p = 0; p < packetCount; p++)
+		{
+			for(int k = 0; k < 4; k++)
+			{
+				if(packets[p]._valid[k] == 0.0f)
+					continue;
+				const float* corner[3] = { packets[p]._a[0], packets[p]._b[0], packets[p]._c[0] };
+				for(int v = 0; v < 3; v++)
+				{
+					_drawIndex.push_back((unsigned int)_drawCoord.size() / 3);
+					for(int a = 0; a < 3; a++)
+					{
+						_drawCoord.push_back(corner[v][4 * a + k]);
+					}
+				}
+			}
+		}
+	}
+
+	if(!_drawIndex.empty())
+		Graphics::DrawTriangles((int)_drawIndex.size(), &_drawIndex[0], &_drawCoord[0], _red, _green, _blue);
+}
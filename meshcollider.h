@@ -0,0 +1,129 @@
+// meshcollider.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef MESHCOLLIDER_H
+#define MESHCOLLIDER_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "vector.h"
+
+class ParticleStore;
+
+// No da hierarquia da malha, no mesmo arranjo de AabbNode: pre-ordem com
+// salto, 32 bytes. As folhas apontam um pacote de ate 4 triangulos.
+struct MeshNode
+{
+	float _min[3];
+	int _skip;
+	float _max[3];
+	// pacote da folha; -1 nos nos internos
+	int _packet;
+};
+
+// Pacote de 4 triangulos em estrutura de vetores: cada linha guarda o mesmo
+// campo dos 4 triangulos, lido com uma unica carga SSE. Faixas sem triangulo
+// repetem um triangulo da folha e tem _valid zero.
+struct MeshPacket
+{
+	float _a[3][4];
+	float _b[3][4];
+	float _c[3][4];
+	// normal unitaria, com a, b, c em sentido anti-horario
+	float _n[3][4];
+	// inverso do quadrado do comprimento das arestas ab, bc e ca
+	float _inverse[3][4];
+	float _valid[4];
+};
+
+// Cabecalho do arquivo da hierarquia, seguido dos nos e dos pacotes
+struct MeshHeader
+{
+	char _magic[8];
+	int _version;
+	int _nodeCount;
+	int _packetCount;
+	int _triangleCount;
+	int _reserved[2];
+};
+
+// Obstaculo estatico descrito por uma malha de triangulos (lida de OBJ ou
+// PLY, ver MeshFile). Os triangulos sao organizados uma unica vez em uma
+// hierarquia de caixas (SAH em faixas) achatada em um bloco contiguo e
+// imutavel: cabecalho, nos em pre-ordem e pacotes de 4 triangulos por folha.
+// O bloco e o proprio formato do arquivo .bvh: Save grava o bloco e Map
+// mapeia o arquivo na memoria e usa os nos e pacotes no lugar, sem
+// reconstrucao nem copia, de modo que malhas grandes carregam rapido.
+// Cada particula percorre a hierarquia com a caixa da sua esfera e testa os
+// 4 triangulos de cada folha atingida de uma vez; o triangulo mais proximo
+// define o contato. A frente de cada triangulo e o lado para onde aponta
+// a normal dos vertices em sentido anti-horario, como em OBJ e PLY. A
+// malha tem _thickness de espessura atras das faces: uma particula cujo
+// centro atravessou a face, mas nao a espessura, e devolvida para a frente,
+// o que evita que particulas rapidas atravessem a superficie em um passo.
+// A resposta e a mesma dos planos: a particula que penetra e empurrada para
+// fora e tem a velocidade refletida e multiplicada pelo fator dissipativo.
+class MeshCollider
+{
+public:
+	MeshCollider();
+	~MeshCollider();
+
+	// profundidade atras das faces, alem do raio, em que as particulas ainda
+	// colidem (padrao 0)
+	float _thickness;
+	float _red, _green, _blue;
+
+	// Constroi a hierarquia de vertices e indices (3 por triangulo);
+	// triangulos degenerados sao descartados
+	void Build(const std::vector<Vector3>& vertices, const std::vector<int>& indices);
+
+	// Le a malha: .bvh e mapeado (ver Map), .obj e .ply sao lidos e construidos
+	bool Load(const char* path);
+
+	// Grava o bloco da hierarquia
+	bool Save(const char* path) const;
+
+	// Mapeia um arquivo gravado por Save; retorna false se ele e invalido
+	bool Map(const char* path);
+
+	// Copia um bloco no formato do arquivo; retorna false se ele e invalido
+	bool SetData(const char* data, size_t size);
+
+	// Verifica o cabecalho, o tamanho e os saltos e pacotes dos nos do bloco
+	static bool Validate(const char* data, size_t size);
+
+	// Bloco da hierarquia (cabecalho, nos e pacotes) e o seu tamanho
+	const char* Data() const;
+	size_t Size() const;
+
+	int TriangleCount() const;
+	int NodeCount() const;
+
+	// Colisao das particulas [begin, end) com a malha. Particulas adormecidas
+	// sao ignoradas.
+	void Collide(ParticleStore* store, float dissipative, int begin, int end) const;
+
+	void Draw();
+
+private:
+	// bloco em uso: _storage ou o arquivo mapeado
+	const char* _data;
+	size_t _size;
+	std::vector<char> _storage;
+	void* _mapping;
+
+	// triangulos para desenho, montados dos pacotes no primeiro Draw
+	std::vector<float> _drawCoord;
+	std::vector<unsigned int> _drawIndex;
+
+	const MeshNode* Nodes() const;
+	const MeshPacket* Packets() const;
+	void Unmap();
+	void Release();
+};
+
+#endif
@@ -0,0 +1,338 @@
+// meshfile.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "meshfile.h"
+
+// tipos escalares das propriedades do PLY
+enum PlyType { PLY_NONE, PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64 };
+
+struct PlyProperty
+{
+	PlyType _type;
+	// tipo da contagem nas listas; PLY_NONE nas propriedades escalares
+	PlyType _countType;
+	std::string _name;
+};
+
+struct PlyElement
+{
+	std::string _name;
+	int _count;
+	std::vector<PlyProperty> _properties;
+};
+
+static PlyType ParsePlyType(const char* name)
+{
+	if(strcmp(name, "char") == 0 || strcmp(name, "int8") == 0)
+		return PLY_INT8;
+	if(strcmp(name, "uchar") == 0 || strcmp(name, "uint8") == 0)
+		return PLY_UINT8;
+	if(strcmp(name, "short") == 0 || strcmp(name, "int16") == 0)
+		return PLY_INT16;
+	if(strcmp(name, "ushort") == 0 || strcmp(name, "uint16") == 0)
+		return PLY_UINT16;
+	if(strcmp(name, "int") == 0 || strcmp(name, "int32") == 0)
+		return PLY_INT32;
+	if(strcmp(name, "uint") == 0 || strcmp(name, "uint32") == 0)
+		return PLY_UINT32;
+	if(strcmp(name, "float") == 0 || strcmp(name, "float32") == 0)
+		return PLY_FLOAT32;
+	if(strcmp(name, "double") == 0 || strcmp(name, "float64") == 0)
+		return PLY_FLOAT64;
+	return PLY_NONE;
+}
+
+// Le uma linha inteira, de qualquer tamanho; retorna false no fim do arquivo
+static bool ReadLine(FILE* file, std::string& line)
+{
+	line.clear();
+	char buffer[1024];
+	while(fgets(buffer, sizeof(buffer), file))
+	{
+		line += buffer;
+		if(!line.empty() && line[line.size()-1] == '\n')
+			return true;
+	}
+	return !line.empty();
+}
+
+// Le um valor do corpo do PLY em texto ou binario little-endian
+static bool ReadPlyValue(FILE* file, bool binary, PlyType type, double& value)
+{
+	if(!binary)
+		return fscanf(file, "%lf", &value) == 1;
+
+	static const int sizes[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+	unsigned char bytes[8];
+	if(fread(bytes, 1, sizes[type], file) != (size_t)sizes[type])
+		return false;
+
+	// montagem byte a byte: independe da ordem dos bytes da maquina
+	unsigned long long bits = 0;
+	for(int k = sizes[type] - 1; k >= 0; k--)
+	{
+		bits = (bits << 8) | bytes[k];
+	}
+
+	switch(type)
+	{
+	case PLY_INT8: value = (signed char)bits; break;
+	case PLY_UINT8: value = (unsigned char)bits; break;
+	case PLY_INT16: value = (short)bits; break;
+	case PLY_UINT16: value = (unsigned short)bits; break;
+	case PLY_INT32: value = (int)bits; break;
+	case PLY_UINT32: value = (unsigned int)bits; break;
+	case PLY_FLOAT32:
+		{
+			unsigned int word = (unsigned int)bits;
+			float f;
+			memcpy(&f, &word, sizeof(f));
+			value = f;
+		}
+		break;
+	case PLY_FLOAT64:
+		{
+			double d;
+			memcpy(&d, &bits, sizeof(d));
+			value = d;
+		}
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+// Divide o poligono em leque de triangulos
+// Contagem ou indice lido de uma lista PLY: inteiro em [0, max]. Valores
+// fora da faixa de int nao podem ser convertidos (a conversao e indefinida)
+static bool PlyInteger(double value, double max, int& result)
+{
+	if(!(value >= 0.0 && value <= max && value == floor(value)))
+		return false;
+	result = (int)value;
+	return true;
+}
+
+static bool AddPolygon(const std::vector<int>& polygon, int vertexCount, std::vector<int>& indices)
+{
+	for(int k = 0; k < (int)polygon.size(); k++)
+	{
+		if(polygon[k] < 0 || polygon[k] >= vertexCount)
+			return false;
+	}
+	for(int k = 2; k < (int)polygon.size(); k++)
+	{
+		indices.push_back(polygon[0]);
+		indices.push_back(polygon[k-1]);
+		indices.push_back(polygon[k]);
+	}
+	return true;
+}
+
+bool MeshFile::Read(const char* path, std::vector<Vector3>& vertices, std::vector<int>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	const char* dot = strrchr(path, '.');
+	if(!dot)
+		return false;
+	std::string suffix;
+	for(const char* c = dot + 1; *c; c++)
+	{
+		suffix += (char)tolower((unsigned char)*c);
+	}
+	if(suffix != "obj" && suffix != "ply")
+		return false;
+
+	FILE* file = fopen(path, "rb");
+	if(!file)
+		return false;
+
+	bool ok = suffix == "obj" ? ReadObj(file, vertices, indices) : ReadPly(file, vertices, indices);
+	fclose(file);
+
+	if(!ok)
+	{
+		vertices.clear();
+		indices.clear();
+	}
+	return ok;
+}
+
+bool MeshFile::ReadObj(FILE* file, std::vector<Vector3>& vertices, std::vector<int>& indices)
+{
+	std::string line;
+	std::vector<int> polygon;
+	while(ReadLine(file, line))
+	{
+		const char* c = line.c_str();
+		while(*c == ' ' || *c == '\t')
+			c++;
+
+		if(c[0] == 'v' && (c[1] == ' ' || c[1] == '\t'))
+		{
+			float x, y, z;
+			if(sscanf(c + 1, "%f %f %f", &x, &y, &z) != 3)
+				return false;
+			vertices.push_back(Vector3(x, y, z));
+		}
+		else if(c[0] == 'f' && (c[1] == ' ' || c[1] == '\t'))
+		{
+			// cada vertice e v, v/vt, v//vn ou v/vt/vn; so v interessa
+			polygon.clear();
+			c++;
+			for(;;)
+			{
+				char* next;
+				long index = strtol(c, &next, 10);
+				if(next == c)
+					break;
+				polygon.push_back(index < 0 ? (int)vertices.size() + (int)index : (int)index - 1);
+				c = next;
+				while(*c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '\n')
+					c++;
+			}
+			if(!AddPolygon(polygon, (int)vertices.size(), indices))
+				return false;
+		}
+	}
+	return true;
+}
+
+bool MeshFile::ReadPly(FILE* file, std::vector<Vector3>& vertices, std::vector<int>& indices)
+{
+	// cabecalho em texto ate end_header
+	std::string line;
+	if(!ReadLine(file, line) || line.compare(0, 3, "ply") != 0)
+		return false;
+
+	bool binary = false;
+	std::vector<PlyElement> elements;
+	for(;;)
+	{
+		if(!ReadLine(file, line))
+			return false;
+
+		char word[64], a[64], b[64], c[64];
+		int words = sscanf(line.c_str(), "%63s %63s %63s %63s", word, a, b, c);
+		if(words < 1)
+			continue;
+
+		if(strcmp(word, "end_header") == 0)
+			break;
+		else if(strcmp(word, "format") == 0 && words >= 2)
+		{
+			if(strcmp(a, "binary_little_endian") == 0)
+				binary = true;
+			else if(strcmp(a, "ascii") != 0)
+				return false;
+		}
+		else if(strcmp(word, "element") == 0 && words >= 3)
+		{
+			PlyElement element;
+			element._name = a;
+			element._count = atoi(b);
+			if(element._count < 0)
+				return false;
+			elements.push_back(element);
+		}
+		else if(strcmp(word, "property") == 0 && words >= 3)
+		{
+			if(elements.empty())
+				return false;
+			PlyProperty property;
+			if(strcmp(a, "list") == 0)
+			{
+				if(words < 4)
+					return false;
+				property._countType = ParsePlyType(b);
+				property._type = ParsePlyType(c);
+				if(property._countType == PLY_NONE)
+					return false;
+				sscanf(line.c_str(), "%*s %*s %*s %*s %63s", c);
+				property._name = c;
+			}
+			else
+			{
+				property._countType = PLY_NONE;
+				property._type = ParsePlyType(a);
+				property._name = b;
+			}
+			if(property._type == PLY_NONE)
+				return false;
+			elements.back()._properties.push_back(property);
+		}
+	}
+
+	// fim do arquivo, que limita o tamanho das listas: cada valor ocupa ao
+	// menos um byte em qualquer formato
+	long body = ftell(file);
+	if(body < 0 || fseek(file, 0, SEEK_END) != 0)
+		return false;
+	long end = ftell(file);
+	if(end < body || fseek(file, body, SEEK_SET) != 0)
+		return false;
+
+	// corpo: os elementos na ordem do cabecalho
+	std::vector<int> polygon;
+	for(int e = 0; e < (int)elements.size(); e++)
+	{
+		const PlyElement& element = elements[e];
+		bool isVertex = element._name == "vertex";
+		bool isFace = element._name == "face";
+
+		for(int n = 0; n < element._count; n++)
+		{
+			double xyz[3] = { 0.0, 0.0, 0.0 };
+			for(int p = 0; p < (int)element._properties.size(); p++)
+			{
+				const PlyProperty& property = element._properties[p];
+				double value;
+				if(property._countType == PLY_NONE)
+				{
+					if(!ReadPlyValue(file, binary, property._type, value))
+						return false;
+					if(isVertex && property._name.size() == 1 && property._name[0] >= 'x' && property._name[0] <= 'z')
+						xyz[property._name[0] - 'x'] = value;
+					continue;
+				}
+
+				int count;
+				if(!ReadPlyValue(file, binary, property._countType, value) ||
+					!PlyInteger(value, (double)(end - ftell(file)), count))
+					return false;
+				bool indexList = isFace && (property._name == "vertex_indices" || property._name == "vertex_index");
+				if(indexList)
+					polygon.clear();
+				for(int k = 0; k < count; k++)
+				{
+					if(!ReadPlyValue(file, binary, property._type, value))
+						return false;
+					if(indexList)
+					{
+						int index;
+						if(!PlyInteger(value, (double)INT_MAX, index))
+							return false;
+						polygon.push_back(index);
+					}
+				}
+				if(indexList && !AddPolygon(polygon, (int)vertices.size(), indices))
+					return false;
+			}
+			if(isVertex)
+				vertices.push_back(Vector3((float)xyz[0], (float)xyz[1], (float)xyz[2]));
+		}
+	}
+	return true;
+}
@@ -0,0 +1,33 @@
+// meshfile.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef MESHFILE_H
+#define MESHFILE_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "vector.h"
+
+// Leitura de malhas de triangulos de arquivos OBJ e PLY. Do OBJ sao lidos
+// os vertices (v) e as faces (f), com indices negativos relativos; do PLY,
+// nos formatos ascii e binary_little_endian, as propriedades x, y e z dos
+// vertices e a lista vertex_indices (ou vertex_index) das faces. Os demais
+// elementos e propriedades sao ignorados. Poligonos sao divididos em leque
+// de triangulos.
+class MeshFile
+{
+public:
+	// Le a malha pelo sufixo do nome (.obj ou .ply); indices recebe 3 indices
+	// de vertice por triangulo. Retorna false se o arquivo nao pode ser lido
+	// ou tem indices invalidos.
+	static bool Read(const char* path, std::vector<Vector3>& vertices, std::vector<int>& indices);
+
+private:
+	static bool ReadObj(FILE* file, std::vector<Vector3>& vertices, std::vector<int>& indices);
+	static bool ReadPly(FILE* file, std::vector<Vector3>& vertices, std::vector<int>& indices);
+};
+
+#endif
@@ -0,0 +1,187 @@
+// mortonorder.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <algorithm>
+
+#include "profiler.h"
+#include "simulation.h"
+#include "mortonorder.h"
+
+// bits por eixo do codigo de Morton; as celulas sao tomadas modulo 2^10
+#define MORTON_BITS 10
+
+MortonOrder::MortonOrder()
+{
+	_enabled = false;
+	_checkInterval = 32;
+	_threshold = 0.1f;
+
+	_reorders = 0;
+	_disorder = 0.0f;
+	_baseline = 0.0f;
+
+	_steps = 0;
+	_cellSize = 0.0f;
+}
+
+// Intercala os 10 bits de v com dois zeros entre cada bit
+static inline unsigned int SpreadBits(unsigned int v)
+{
+	v &= 0x3ff;
+	v = (v | (v << 16)) & 0x030000ff;
+	v = (v | (v << 8)) & 0x0300f00f;
+	v = (v | (v << 4)) & 0x030c30c3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+
+// Operacao inversa: extrai um bit a cada tres
+static inline unsigned int CompactBits(unsigned int v)
+{
+	v &= 0x09249249;
+	v = (v | (v >> 2)) & 0x030c30c3;
+	v = (v | (v >> 4)) & 0x0300f00f;
+	v = (v | (v >> 8)) & 0x030000ff;
+	v = (v | (v >> 16)) & 0x3ff;
+	return v;
+}
+
+// Celula de uma coordenada ja dividida pelo tamanho da celula, deslocada
+// por bias. Como em Grid::Cell, valores fora da faixa de int (e NaN) ficam
+// na celula limite antes da conversao, que para eles seria indefinida
+static inline unsigned int BiasedCell(float v, int bias)
+{
+	float cell = floorf(v);
+	if(!(cell > -GRID_CELL_LIMIT))
+		cell = -GRID_CELL_LIMIT;
+	else if(cell > GRID_CELL_LIMIT)
+		cell = GRID_CELL_LIMIT;
+	return (unsigned int)((int)cell + bias);
+}
+
+// Celulas vizinhas (ou a mesma) em todos os eixos
+static inline bool Neighbors(unsigned int codeA, unsigned int codeB)
+{
+	for(int axis = 0; axis < 3; axis++)
+	{
+		int a = (int)CompactBits(codeA >> axis);
+		int b = (int)CompactBits(codeB >> axis);
+		if(a - b > 1 || b - a > 1)
+			return false;
+	}
+	return true;
+}
+
+void MortonOrder::ComputeKeys(Simulation* simulation)
+{
+	ParticleStore* store = &simulation->_store;
+	int count = store->_count;
+
+	// a mesma celula da grade de colisao (o maior diametro), qualquer que
+	// seja a fase larga em uso
+	_cellSize = 0.0f;
+	for(int i = 0; i < count; i++)
+	{
+		if(2.0f * store->_radius[i] > _cellSize)
+			_cellSize = 2.0f * store->_radius[i];
+	}
+	if(_cellSize <= 0.0f)
+		_cellSize = 1.0f;
+
+	// codigo na parte alta e posicao atual na parte baixa
+	_keys.resize(count);
+	float inverse = 1.0f / _cellSize;
+	simulation->_scheduler.ParallelFor(0, count, simulation->_chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("MortonOrder::Keys", thread);
+		const Vector3* position = store->_currPosition;
+		int bias = 1 << (MORTON_BITS - 1);
+
+		for(int i = begin; i < end; i++)
+		{
+			unsigned int x = BiasedCell(position[i].x * inverse, bias);
+			unsigned int y = BiasedCell(position[i].y * inverse, bias);
+			unsigned int z = BiasedCell(position[i].z * inverse, bias);
+			unsigned int code = SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2);
+			_keys[i] = ((unsigned long long)code << 32) | (unsigned int)i;
+		}
+	});
+}
+
+float MortonOrder::Disorder() const
+{
+	int count = (int)_keys.size();
+	if(count < 2)
+		return 0.0f;
+
+	int far = 0;
+	for(int i = 1; i < count; i++)
+	{
+		if(!Neighbors((unsigned int)(_keys[i] >> 32), (unsigned int)(_keys[i - 1] >> 32)))
+			far++;
+	}
+	return (float)far / (float)(count - 1);
+}
+
+bool MortonOrder::Update(Simulation* simulation)
+{
+	if(!_enabled)
+		return false;
+	if(++_steps < _checkInterval)
+		return false;
+	_steps = 0;
+
+	PROFILE_ZONE("MortonOrder::Update", 0);
+
+	int count = simulation->_store._count;
+	if(count < 2)
+		return false;
+
+	ComputeKeys(simulation);
+	_disorder = Disorder();
+
+	if(_disorder <= _baseline + _threshold)
+	{
+		_keys.clear();
+		return false;
+	}
+
+	Reorder(simulation);
+	return true;
+}
+
+void MortonOrder::Reorder(Simulation* simulation)
+{
+	PROFILE_ZONE("MortonOrder::Reorder", 0);
+
+	ParticleStore* store = &simulation->_store;
+	int count = store->_count;
+	if((int)_keys.size() != count)
+		ComputeKeys(simulation);
+
+	// o indice na parte baixa desempata codigos iguais pela ordem atual
+	std::sort(_keys.begin(), _keys.end());
+	_baseline = Disorder();
+
+	_order.resize(count);
+	_newIndex.resize(count);
+	for(int i = 0; i < count; i++)
+	{
+		_order[i] = (int)(_keys[i] & 0xffffffffu);
+		_newIndex[_order[i]] = i;
+	}
+
+	if(count > 0)
+	{
+		store->Permute(&_order[0]);
+		simulation->_springs.Remap(&_newIndex[0]);
+		simulation->_constraints.Remap(&_newIndex[0], count);
+		simulation->_islands.Remap(&_order[0], &_newIndex[0], count);
+	}
+
+	_keys.clear();
+	_reorders++;
+}
@@ -0,0 +1,62 @@
+// mortonorder.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef MORTONORDER_H
+#define MORTONORDER_H
+
+#include <vector>
+
+class Simulation;
+
+// Reordenacao periodica das particulas pela curva de Morton (ordem Z) da
+// celula da grade em que estao, para que particulas vizinhas no espaco
+// fiquem proximas na memoria e os lacos de colisao e de molas acessem
+// dados contiguos.
+// A cada _checkInterval passos a desordem e medida como a fracao de
+// particulas consecutivas na memoria que estao em celulas nao vizinhas.
+// Mesmo logo apos a ordenacao essa fracao nao e nula (a curva salta entre
+// blocos e particulas esparsas tem celulas vazias entre si), por isso a
+// reordenacao ocorre quando a desordem passa a medida logo apos a ultima
+// reordenacao por mais de _threshold. Um arranjo ja coerente, como a malha
+// de um tecido em ordem de linhas, nao e reordenado. A reordenacao remapeia
+// os indices das molas e restricoes, o estado das ilhas e a tabela de
+// identificadores do ParticleStore, pela qual objetos e gravadores
+// encontram suas particulas.
+class MortonOrder
+{
+public:
+	MortonOrder();
+
+	bool _enabled;
+	int _checkInterval;
+	float _threshold;
+
+	// estatisticas: numero de reordenacoes, ultima desordem medida e
+	// desordem logo apos a ultima reordenacao
+	int _reorders;
+	float _disorder;
+	float _baseline;
+
+	// Mede a desordem a cada _checkInterval chamadas e reordena se
+	// necessario; retorna true se reordenou
+	bool Update(Simulation* simulation);
+
+	// Reordena incondicionalmente
+	void Reorder(Simulation* simulation);
+
+private:
+	friend class Checkpoint;
+
+	int _steps;
+	float _cellSize;
+	std::vector<unsigned long long> _keys;
+	std::vector<int> _order;
+	std::vector<int> _newIndex;
+
+	void ComputeKeys(Simulation* simulation);
+	float Disorder() const;
+};
+
+#endif
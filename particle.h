@@ -14,7 +14,9 @@ public:
 	enum ParticleType
 	{
 		PASSIVE,
-		ACTIVE
+		ACTIVE,
+		// ativa em repouso: nao e integrada ate ser acordada (ver islands.h)
+		SLEEPING
 	};
 
 	Particle();
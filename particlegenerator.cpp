@@ -3,17 +3,30 @@
 // L. Camello - camello@tecgraf.puc-rio.br
 // PUC-Rio, Out 2009
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <time.h>
-
-#include "graphics.h"
+#include "profiler.h"
+#include "simulation.h"
 
 #include "particlegenerator.h"
 
 ParticleGenerator::ParticleGenerator()
 {
-	srand((int)time(NULL));
+	_enabled = true;
+	_max = 0;
+	_mass = 1.0f;
+	_radius = 0.1f;
+	_rate = 0.0f;
+	_lifetime = 0.0f;
+	_burst = 0;
+	_position = Vector3(0.0f, 0.0f, 0.0f);
+	_extent = Vector3(0.0f, 0.0f, 0.0f);
+	_velocity = Vector3(0.0f, 0.0f, 0.0f);
+	_spread = Vector3(0.0f, 0.0f, 0.0f);
+	_generated = 0;
+
+	_time = 0.0;
+	_accumulator = 0.0f;
+	_head = 0;
+	_live = 0;
 }
 
 ParticleGenerator::~ParticleGenerator()
@@ -26,69 +39,128 @@ void ParticleGenerator::Initialize(
 {
 	_mass = m;
 	_radius = radius;
-	_max = max;
 	_position = Vector3(x, y, z);
+	_extent = Vector3(2.0f, 500.0f, 2.0f);
 	_generated = 0;
+	_rate = 0.0f;
+	_lifetime = 0.0f;
+	_burst = max;
+	Resize(max);
+}
+
+void ParticleGenerator::Resize(int max)
+{
+	_max = max;
+	_ring.assign(max, ParticleHandle());
+	_birth.assign(max, 0.0);
+	_head = 0;
+	_live = 0;
+}
+
+void ParticleGenerator::Start(Simulation* simulation)
+{
+	// reserva o anel inteiro de uma vez
+	ParticleStore* store = &simulation->_store;
+	simulation->Reserve(store->_count + _max, simulation->_springs._count, simulation->_constraints._count);
+
+	Emit(simulation, _burst);
+}
+
+void ParticleGenerator::Update(Simulation* simulation, float timeStep)
+{
+	if(!_enabled || _max == 0)
+		return;
+
+	PROFILE_ZONE("ParticleGenerator::Update", 0);
 
-	for( int i = 0; i < max; i++ )
+	_time += timeStep;
+	_accumulator += _rate * timeStep;
+	int emissions = (int)_accumulator;
+	_accumulator -= (float)emissions;
+
+	Emit(simulation, emissions);
+
+	// as particulas expiradas que nao foram reaproveitadas saem da simulacao
+	if(_lifetime <= 0.0f)
+		return;
+	while(_live > 0 && _time - _birth[_head] >= _lifetime)
 	{
-		/*_particles[i] = NULL;*/
-		float r, g, b;
-		float px, py, pz;
-		
-		r = RandomNonNegativeNumber(1);
-		g = RandomNonNegativeNumber(1);
-		b = RandomNonNegativeNumber(1);
-
-		px = RandomNumber(2) + _position.x;
-		py = RandomNonNegativeNumber(500) + _position.y;
-		pz = RandomNumber(2) + _position.z;
-
-		_particles[i] = new Particle();
-		_particles[i]->Initialize( 
-			_mass, _radius,
-			px, py, pz,
-			r, g, b,
-			Particle::ParticleType::ACTIVE);
+		simulation->RemoveParticle(_ring[_head]);
+		_head = (_head + 1) % _max;
+		_live--;
 	}
 }
 
-void ParticleGenerator::Update()
+void ParticleGenerator::Sample(Simulation* simulation, int count)
 {
-	/*float r, g, b;
-	float px, py, pz;
-	
-	r = RandomNonNegativeNumber(1);
-	g = RandomNonNegativeNumber(1);
-	b = RandomNonNegativeNumber(1);
-
-	px = RandomNumber(4);
-	py = RandomNonNegativeNumber(25);
-	pz = RandomNumber(4);
-
-	_particles[_generated] = new Particle();
-	_particles[_generated]->Initialize( 
-		_mass, _radius,
-		px, py, pz,
-		r, g, b,
-		Particle::ParticleType::ACTIVE);
+	int values = 9 * count;
+	if((int)_samples.size() < values)
+		_samples.resize(values);
 
-	_generated++;*/
+	// cada bloco sorteia o seu trecho da sequencia; o resultado nao depende
+	// da divisao entre threads
+	unsigned long long first = 9ull * (unsigned int)_generated;
+	simulation->_scheduler.ParallelFor(0, values, simulation->_chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("ParticleGenerator::Sample", thread);
+		_random.Fill(first + begin, &_samples[begin], end - begin);
+	});
 }
 
-float ParticleGenerator::RandomNumber(int randmax)
+void ParticleGenerator::Emit(Simulation* simulation, int count)
 {
-	int random = rand();
-	if(random%2==0)
+	if(count <= 0)
+		return;
+
+	Sample(simulation, count);
+	for(int i = 0; i < count; i++)
 	{
-		random = -random;
+		Emit(simulation, &_samples[9 * i]);
 	}
-	float scale = random / (float)RAND_MAX;
-	return scale * randmax;
 }
 
-float ParticleGenerator::RandomNonNegativeNumber(int randmax)
+void ParticleGenerator::Emit(Simulation* simulation, const float* sample)
 {
-	float scale = rand() / (float)RAND_MAX;
-	return scale * randmax;
+	ParticleStore* store = &simulation->_store;
+
+	// cor, posicao (x e z para os dois lados, y para cima) e velocidade
+	Particle particle;
+	particle.Initialize(
+		_mass, _radius,
+		_position.x + _extent.x * (2.0f * sample[3] - 1.0f),
+		_position.y + _extent.y * sample[4],
+		_position.z + _extent.z * (2.0f * sample[5] - 1.0f),
+		_velocity.x + _spread.x * (2.0f * sample[6] - 1.0f),
+		_velocity.y + _spread.y * (2.0f * sample[7] - 1.0f),
+		_velocity.z + _spread.z * (2.0f * sample[8] - 1.0f),
+		sample[0], sample[1], sample[2],
+		Particle::ParticleType::ACTIVE);
+
+	// com o anel cheio ou a mais antiga expirada, a mais antiga renasce
+	while(_live > 0 && (_live == _max || (_lifetime > 0.0f && _time - _birth[_head] >= _lifetime)))
+	{
+		ParticleHandle handle = _ring[_head];
+		_head = (_head + 1) % _max;
+		_live--;
+
+		// particulas removidas por outros apenas saem do anel
+		int index = store->Find(handle);
+		if(index < 0)
+			continue;
+
+		store->Set(index, particle);
+		int tail = (_head + _live) % _max;
+		_ring[tail] = handle;
+		_birth[tail] = _time;
+		_live++;
+		_generated++;
+		return;
+	}
+
+	int index = simulation->AddParticle(&particle);
+	int tail = (_head + _live) % _max;
+	_ring[tail] = store->Handle(index);
+	_birth[tail] = _time;
+	_live++;
+	_generated++;
 }
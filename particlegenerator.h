@@ -6,33 +6,83 @@
 #ifndef PARTICLEGENERATOR_H
 #define PARTICLEGENERATOR_H
 
+#include <vector>
+
 #include "vector.h"
+#include "random.h"
 #include "particle.h"
+#include "particlestore.h"
+
+class Simulation;
 
+// Emissor de particulas. Emite uma rajada de _burst particulas quando e
+// adicionado a simulacao e, a cada passo, _rate particulas por segundo (a
+// fracao que sobra fica acumulada para o passo seguinte). Cada particula
+// nasce em uma posicao sorteada a partir de _position (ate _extent.x e
+// _extent.z para os dois lados e ate _extent.y para cima) com velocidade
+// _velocity mais uma variacao de ate _spread em cada eixo.
+// Os sorteios vem de _random (gerador baseado em contador): a emissao n usa
+// os numeros [9n, 9n + 9) do fluxo, de modo que a sequencia depende apenas
+// da semente e nao da ordem ou da thread em que os lotes sao sorteados.
+// As particulas vivas ficam em um anel de no maximo _max handles, em ordem
+// de emissao. Particulas com mais de _lifetime segundos (0: sem limite) sao
+// reaproveitadas pelas proximas emissoes, e as que sobram sao removidas da
+// simulacao; com o anel cheio, a emissao reaproveita a particula mais
+// antiga. Depois que o anel e o ParticleStore atingem o tamanho maximo a
+// emissao nao aloca memoria.
 class ParticleGenerator
 {
 public:
 	ParticleGenerator();
 	~ParticleGenerator();
 
+	bool _enabled;
 	int _max;
 	float _mass;
 	float _radius;
-	int _generated;
+	float _rate;
+	float _lifetime;
+	int _burst;
 	Vector3 _position;
-	Particle* _particles[128];
+	Vector3 _extent;
+	Vector3 _velocity;
+	Vector3 _spread;
+	// semente e fluxo dos sorteios; a semente padrao e fixa
+	Random _random;
 
+	// total de particulas emitidas
+	int _generated;
 
-    void Initialize(
-		float m, 
-		float radius, 
+	// tempo do emissor, fracao de particula acumulada e anel das particulas
+	// vivas: _live handles a partir de _head, com o instante de nascimento
+	double _time;
+	float _accumulator;
+	int _head;
+	int _live;
+	std::vector<ParticleHandle> _ring;
+	std::vector<double> _birth;
+
+	// Rajada inicial de max particulas em queda, sem emissao continua
+	void Initialize(
+		float m,
+		float radius,
 		int max,
 		float x, float y, float z);
-	void Update();
+	// Ajusta o tamanho do anel; descarta as particulas registradas
+	void Resize(int max);
+
+	// Emite a rajada inicial
+	void Start(Simulation* simulation);
+	// Avanca o emissor por timeStep segundos: emite, reaproveita e remove
+	void Update(Simulation* simulation, float timeStep);
 
 private:
-	float RandomNumber(int randmax);
-	float RandomNonNegativeNumber(int randmax);
+	// sorteios das emissoes do passo, 9 por particula
+	std::vector<float> _samples;
+
+	void Emit(Simulation* simulation, int count);
+	void Emit(Simulation* simulation, const float* sample);
+	void Sample(Simulation* simulation, int count);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,229 @@
+// particlestore.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <string.h>
+
+#include "aligned.h"
+#include "particlestore.h"
+
+ParticleStore::ParticleStore()
+{
+	_count = 0;
+	_capacity = 0;
+
+	_currPosition = 0;
+	_prevPosition = 0;
+	_currVelocity = 0;
+	_resultantForce = 0;
+	_mass = 0;
+	_inverseMass = 0;
+	_radius = 0;
+	_particleType = 0;
+	_color = 0;
+	_id = 0;
+}
+
+ParticleStore::~ParticleStore()
+{
+	AlignedFree(_currPosition);
+	AlignedFree(_prevPosition);
+	AlignedFree(_currVelocity);
+	AlignedFree(_resultantForce);
+	AlignedFree(_mass);
+	AlignedFree(_inverseMass);
+	AlignedFree(_radius);
+	AlignedFree(_particleType);
+	AlignedFree(_color);
+	AlignedFree(_id);
+}
+
+void ParticleStore::Reserve(int capacity)
+{
+	if(capacity <= _capacity)
+		return;
+
+	AlignedResize(_currPosition, _count, capacity);
+	AlignedResize(_prevPosition, _count, capacity);
+	AlignedResize(_currVelocity, _count, capacity);
+	AlignedResize(_resultantForce, _count, capacity);
+	AlignedResize(_mass, _count, capacity);
+	AlignedResize(_inverseMass, _count, capacity);
+	AlignedResize(_radius, _count, capacity);
+	AlignedResize(_particleType, _count, capacity);
+	AlignedResize(_color, 3 * _count, 3 * capacity);
+	AlignedResize(_id, _count, capacity);
+
+	_capacity = capacity;
+}
+
+void ParticleStore::Resize(int count)
+{
+	Reserve(count);
+	_count = count;
+}
+
+int ParticleStore::Add(const Particle& particle)
+{
+	if(_freeIds.empty())
+		return Insert(particle, (int)_slot.size());
+
+	int id = _freeIds.back();
+	_freeIds.pop_back();
+	return Insert(particle, id);
+}
+
+int ParticleStore::Insert(const Particle& particle, int id)
+{
+	if(_count == _capacity)
+		Reserve(_capacity < 64 ? 64 : 2 * _capacity);
+
+	int i = _count;
+	Set(i, particle);
+	_id[i] = id;
+	if(id == (int)_slot.size())
+	{
+		_slot.push_back(i);
+		_generation.push_back(0);
+	}
+	else
+		_slot[id] = i;
+	_count++;
+
+	return i;
+}
+
+void ParticleStore::Set(int index, const Particle& particle)
+{
+	_currPosition[index] = particle._currPosition;
+	_prevPosition[index] = particle._prevPosition;
+	_currVelocity[index] = particle._currVelocity;
+	_resultantForce[index] = particle._resultantForce;
+	_mass[index] = particle._mass;
+	_inverseMass[index] = 1.0f / particle._mass;
+	_radius[index] = particle._radius;
+	_particleType[index] = particle._particleType;
+	_color[3*index+0] = particle._red;
+	_color[3*index+1] = particle._green;
+	_color[3*index+2] = particle._blue;
+}
+
+int ParticleStore::AddRange(const Particle* particles, int count, int* firstId)
+{
+	if(_count + count > _capacity)
+	{
+		int capacity = _capacity < 64 ? 64 : 2 * _capacity;
+		while(capacity < _count + count)
+			capacity *= 2;
+		Reserve(capacity);
+	}
+
+	int first = _count;
+	*firstId = (int)_slot.size();
+	for(int i = 0; i < count; i++)
+	{
+		Insert(particles[i], (int)_slot.size());
+	}
+	return first;
+}
+
+int ParticleStore::Remove(int index)
+{
+	int id = _id[index];
+	_slot[id] = -1;
+	_generation[id]++;
+	_freeIds.push_back(id);
+
+	int last = --_count;
+	if(index == last)
+		return -1;
+
+	_currPosition[index] = _currPosition[last];
+	_prevPosition[index] = _prevPosition[last];
+	_currVelocity[index] = _currVelocity[last];
+	_resultantForce[index] = _resultantForce[last];
+	_mass[index] = _mass[last];
+	_inverseMass[index] = _inverseMass[last];
+	_radius[index] = _radius[last];
+	_particleType[index] = _particleType[last];
+	_color[3*index+0] = _color[3*last+0];
+	_color[3*index+1] = _color[3*last+1];
+	_color[3*index+2] = _color[3*last+2];
+	_id[index] = _id[last];
+	_slot[_id[index]] = index;
+
+	return last;
+}
+
+ParticleHandle ParticleStore::Handle(int index) const
+{
+	int id = _id[index];
+	return ParticleHandle(id, _generation[id]);
+}
+
+int ParticleStore::Find(ParticleHandle handle) const
+{
+	if(handle._id < 0 || handle._id >= (int)_slot.size())
+		return -1;
+	if(_generation[handle._id] != handle._generation)
+		return -1;
+	return _slot[handle._id];
+}
+
+void ParticleStore::ResetForces(int begin, int end)
+{
+	for(int i = begin; i < end; i++)
+	{
+		if(_particleType[i] == Particle::ParticleType::ACTIVE)
+			_resultantForce[i] = Vector3(0.0f, 0.0f, 0.0f);
+	}
+}
+
+template <class T>
+void ParticleStore::Gather(T* data, const int* order, int stride)
+{
+	_scratch.resize(_count * stride * sizeof(T));
+	T* copy = (T*)&_scratch[0];
+	memcpy((void*)copy, data, _count * stride * sizeof(T));
+
+	for(int i = 0; i < _count; i++)
+	{
+		for(int k = 0; k < stride; k++)
+			data[i * stride + k] = copy[order[i] * stride + k];
+	}
+}
+
+void ParticleStore::Permute(const int* order)
+{
+	if(_count == 0)
+		return;
+
+	Gather(_currPosition, order, 1);
+	Gather(_prevPosition, order, 1);
+	Gather(_currVelocity, order, 1);
+	Gather(_resultantForce, order, 1);
+	Gather(_mass, order, 1);
+	Gather(_inverseMass, order, 1);
+	Gather(_radius, order, 1);
+	Gather(_particleType, order, 1);
+	Gather(_color, order, 3);
+	Gather(_id, order, 1);
+
+	RebuildSlots();
+}
+
+void ParticleStore::RebuildSlots()
+{
+	int ids = (int)_generation.size();
+	for(int i = 0; i < _count; i++)
+	{
+		if(_id[i] + 1 > ids)
+			ids = _id[i] + 1;
+	}
+
+	_generation.resize(ids, 0);
+	_slot.assign(ids, -1);
+	for(int i = 0; i < _count; i++)
+		_slot[_id[i]] = i;
+}
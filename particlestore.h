@@ -0,0 +1,109 @@
+// particlestore.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef PARTICLESTORE_H
+#define PARTICLESTORE_H
+
+#include <vector>
+
+#include "vector.h"
+#include "particle.h"
+
+// Referencia estavel a uma particula: identificador e geracao. O
+// identificador nao muda quando a particula troca de posicao no
+// armazenamento; a geracao distingue a particula de outra que venha a
+// reutilizar o identificador depois que ela for removida.
+class ParticleHandle
+{
+public:
+	ParticleHandle() { _id = -1; _generation = 0; }
+	ParticleHandle(int id, int generation) { _id = id; _generation = generation; }
+
+	int _id;
+	int _generation;
+};
+
+// Armazenamento das particulas do sistema em estrutura de vetores (SoA).
+// Cada atributo fica em um vetor contiguo e alinhado, de modo que as fases
+// da simulacao sejam varreduras lineares. O estado usado apenas no desenho
+// (cores) fica separado do estado fisico.
+// Objetos (cubo, pano, gerador) registram suas particulas como um intervalo
+// [first, first + count) de identificadores e passam a ler o estado daqui.
+// Os identificadores formam um slot map: o identificador de uma particula
+// nao muda enquanto ela existir, a posicao (slot) nos vetores pode mudar
+// quando as particulas sao reordenadas (Permute) ou removidas (Remove), e
+// _slot traduz identificador em posicao. Os vetores continuam densos: a
+// remocao move a ultima particula para a posicao liberada. Identificadores
+// de particulas removidas sao reutilizados por Add com a geracao
+// incrementada, de modo que referencias antigas (ParticleHandle) deixam de
+// ser encontradas. Insercao, remocao e traducao sao O(1).
+class ParticleStore
+{
+public:
+	ParticleStore();
+	~ParticleStore();
+
+	int _count;
+	int _capacity;
+
+	Vector3* _currPosition;
+	Vector3* _prevPosition;
+	Vector3* _currVelocity;
+	Vector3* _resultantForce;
+	float* _mass;
+	float* _inverseMass;
+	float* _radius;
+	Particle::ParticleType* _particleType;
+
+	float* _color;
+
+	// identificador da particula em cada posicao e, por identificador,
+	// posicao (-1 se removida) e geracao; identificadores livres para reuso
+	int* _id;
+	std::vector<int> _slot;
+	std::vector<int> _generation;
+	std::vector<int> _freeIds;
+
+	void Reserve(int capacity);
+	// Ajusta o numero de particulas; o conteudo das novas fica indefinido
+	void Resize(int count);
+	// Adiciona uma particula ao final e retorna sua posicao
+	int Add(const Particle& particle);
+	// Adiciona particulas com identificadores novos e consecutivos (objetos
+	// registram o intervalo de identificadores); retorna a primeira posicao
+	// e, em firstId, o primeiro identificador. Os dois so coincidem enquanto
+	// nenhuma particula tiver sido removida
+	int AddRange(const Particle* particles, int count, int* firstId);
+	// Substitui o estado da particula da posicao index, mantendo o
+	// identificador
+	void Set(int index, const Particle& particle);
+	// Remove a particula da posicao index movendo a ultima para o seu lugar;
+	// retorna a posicao anterior da particula movida (-1 se nenhuma)
+	int Remove(int index);
+	void ResetForces(int begin, int end);
+
+	// Reordena as particulas: a particula da posicao order[i] passa para a
+	// posicao i
+	void Permute(const int* order);
+	// Refaz _slot a partir de _id e _generation (apos restaura-los diretamente)
+	void RebuildSlots();
+
+	ParticleHandle Handle(int index) const;
+	// Posicao atual da particula ou -1 se ela foi removida
+	int Find(ParticleHandle handle) const;
+
+private:
+	std::vector<char> _scratch;
+
+	int Insert(const Particle& particle, int id);
+
+	template <class T>
+	void Gather(T* data, const int* order, int stride);
+
+	ParticleStore(const ParticleStore&);
+	ParticleStore& operator= (const ParticleStore&);
+};
+
+#endif
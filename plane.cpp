@@ -5,7 +5,9 @@
 
 #include "graphics.h"
 
+#include "simd.h"
 #include "vector.h"
+#include "particlestore.h"
 #include "plane.h"
 
 Plane::Plane()
@@ -26,8 +28,19 @@ void Plane::Initialize(
 	_green = g;
 	_blue = b;
 	_size = size;
+	Set(normal, position);
+}
+
+void Plane::Set(Vector3 normal, Vector3 position)
+{
 	_normal = normal;
 	_position = position;
+
+	_unitNormal = normal;
+	_unitNormal.Normalize();
+	_d = -(position.x * _unitNormal.x +
+		position.y * _unitNormal.y +
+		position.z * _unitNormal.z);
 }
 
 void Plane::Update()
@@ -45,3 +58,153 @@ void Plane::Draw()
 			_normal.z,
 			_size, _red, _green, _blue);
 }
+
+void Plane::CollideScalar(const std::vector<Plane*>& planes, ParticleStore* store, float dissipative, int begin, int end)
+{
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+	float* radius = store->_radius;
+	Particle::ParticleType* type = store->_particleType;
+
+	for(int i = begin; i < end; i++)
+	{
+		if(type[i] == Particle::SLEEPING)
+			continue;
+
+		for(int j = 0; j < (int)planes.size(); j++)
+		{
+			Vector3 normal = planes[j]->_unitNormal;
+
+			float distance = position[i].x * normal.x +
+				position[i].y * normal.y +
+				position[i].z * normal.z + planes[j]->_d;
+
+			distance -= radius[i];
+
+			if(distance < 0.0f)
+			{
+				Vector3 t = normal;
+				t *= -distance;
+				position[i] += t;
+
+				t = normal;
+				t *= Dot(velocity[i], normal);
+
+				t *= 2.0f;
+
+				velocity[i] -= t;
+
+				velocity[i] *= dissipative;
+			}
+		}
+	}
+}
+
+#ifdef SIMD_SSE
+// planos do caminho SSE; acima disso as colisoes usam o caminho escalar
+static const int SIMD_PLANES = 16;
+#endif
+
+void Plane::Collide(const std::vector<Plane*>& planes, ParticleStore* store, float dissipative, int begin, int end)
+{
+	int i = begin;
+
+#ifdef SIMD_SSE
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+	float* radius = store->_radius;
+	Particle::ParticleType* type = store->_particleType;
+	int planeCount = (int)planes.size();
+
+	// equacoes replicadas nas 4 faixas: nx, ny, nz, d de cada plano
+	__m128 equation[4 * SIMD_PLANES];
+	for(int j = 0; j < planeCount && j < SIMD_PLANES; j++)
+	{
+		equation[4*j] = _mm_set1_ps(planes[j]->_unitNormal.x);
+		equation[4*j+1] = _mm_set1_ps(planes[j]->_unitNormal.y);
+		equation[4*j+2] = _mm_set1_ps(planes[j]->_unitNormal.z);
+		equation[4*j+3] = _mm_set1_ps(planes[j]->_d);
+	}
+
+	SIMD_ALIGN(16) float px[4], py[4], pz[4];
+	SIMD_ALIGN(16) float vx[4], vy[4], vz[4];
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 scale = _mm_set1_ps(dissipative);
+	const __m128i sleeping = _mm_set1_epi32(Particle::SLEEPING);
+
+	for(; planeCount <= SIMD_PLANES && i + 4 <= end; i += 4)
+	{
+		__m128 x, y, z;
+		SimdLoad3(&position[i].x, x, y, z);
+		__m128 rad = _mm_loadu_ps(radius + i);
+
+		// teste contra todos os planos antes de tocar nas velocidades: o
+		// lote quase sempre esta longe das paredes
+		__m128 any = zero;
+		for(int j = 0; j < planeCount; j++)
+		{
+			const __m128* e = equation + 4 * j;
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(x, e[0]), _mm_mul_ps(y, e[1])), _mm_mul_ps(z, e[2])), e[3]);
+			any = _mm_or_ps(any, _mm_cmplt_ps(_mm_sub_ps(distance, rad), zero));
+		}
+		if(_mm_movemask_ps(any) == 0)
+			continue;
+
+		__m128i types = _mm_set_epi32(type[i+3], type[i+2], type[i+1], type[i]);
+		__m128 active = _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(types, sleeping), _mm_set1_epi32(-1)));
+		int lanes = _mm_movemask_ps(_mm_and_ps(any, active));
+		if(lanes == 0)
+			continue;
+
+		__m128 u, v, w;
+		SimdLoad3(&velocity[i].x, u, v, w);
+
+		// resposta por mascara, plano a plano, na mesma ordem e com as mesmas
+		// operacoes do caminho escalar
+		for(int j = 0; j < planeCount; j++)
+		{
+			const __m128* e = equation + 4 * j;
+			__m128 nx = e[0];
+			__m128 ny = e[1];
+			__m128 nz = e[2];
+
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(x, nx), _mm_mul_ps(y, ny)), _mm_mul_ps(z, nz)), e[3]);
+			distance = _mm_sub_ps(distance, rad);
+			__m128 hit = _mm_and_ps(_mm_cmplt_ps(distance, zero), active);
+			if(_mm_movemask_ps(hit) == 0)
+				continue;
+
+			__m128 depth = _mm_sub_ps(zero, distance);
+			x = SimdSelect(hit, _mm_add_ps(x, _mm_mul_ps(nx, depth)), x);
+			y = SimdSelect(hit, _mm_add_ps(y, _mm_mul_ps(ny, depth)), y);
+			z = SimdSelect(hit, _mm_add_ps(z, _mm_mul_ps(nz, depth)), z);
+
+			__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(u, nx), _mm_mul_ps(v, ny)), _mm_mul_ps(w, nz));
+			u = SimdSelect(hit, _mm_mul_ps(_mm_sub_ps(u, _mm_mul_ps(_mm_mul_ps(nx, dot), two)), scale), u);
+			v = SimdSelect(hit, _mm_mul_ps(_mm_sub_ps(v, _mm_mul_ps(_mm_mul_ps(ny, dot), two)), scale), v);
+			w = SimdSelect(hit, _mm_mul_ps(_mm_sub_ps(w, _mm_mul_ps(_mm_mul_ps(nz, dot), two)), scale), w);
+		}
+
+		// devolve apenas as particulas que tocaram algum plano
+		_mm_store_ps(px, x);
+		_mm_store_ps(py, y);
+		_mm_store_ps(pz, z);
+		_mm_store_ps(vx, u);
+		_mm_store_ps(vy, v);
+		_mm_store_ps(vz, w);
+		for(int k = 0; k < 4; k++)
+		{
+			if((lanes & (1 << k)) == 0)
+				continue;
+			position[i+k] = Vector3(px[k], py[k], pz[k]);
+			velocity[i+k] = Vector3(vx[k], vy[k], vz[k]);
+		}
+	}
+#endif
+
+	CollideScalar(planes, store, dissipative, i, end);
+}
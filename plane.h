@@ -6,8 +6,12 @@
 #ifndef PLANE_H
 #define PLANE_H
 
+#include <vector>
+
 #include "vector.h"
 
+class ParticleStore;
+
 class Plane
 {
 public:
@@ -19,13 +23,31 @@ public:
 	Vector3 _position;
 	float _red, _green, _blue, _alpha;
 
+	// equacao do plano (n . x + d = 0) com a normal unitaria; calculada por
+	// Initialize e Set
+	Vector3 _unitNormal;
+	float _d;
+
 	void Initialize(
 		float size, 
 		Vector3 normal, 
 		Vector3 position, 
 		float r, float g, float b);
+	// Muda a normal e o ponto do plano e recalcula a equacao
+	void Set(Vector3 normal, Vector3 position);
 	void Update();
 	void Draw();
+
+	// Colisao das particulas [begin, end) com todos os planos: a particula
+	// que penetra um plano e empurrada para fora e tem a velocidade refletida
+	// e multiplicada por dissipative. Particulas adormecidas sao ignoradas.
+	// Com SSE (e ate 16 planos) as particulas sao processadas em lotes de 4
+	// contra todos os planos, com a resposta aplicada por mascara; o
+	// resultado e o mesmo do caminho escalar.
+	static void Collide(const std::vector<Plane*>& planes, ParticleStore* store, float dissipative, int begin, int end);
+
+private:
+	static void CollideScalar(const std::vector<Plane*>& planes, ParticleStore* store, float dissipative, int begin, int end);
 };
 
 #endif
\ No newline at end of file
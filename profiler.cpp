@@ -0,0 +1,104 @@
+// profiler.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <stdio.h>
+#include <chrono>
+
+#include "profiler.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const Clock::time_point s_origin = Clock::now();
+
+Profiler::Buffer Profiler::s_buffers[PROFILER_THREADS];
+int Profiler::s_capacity = 0;
+bool Profiler::s_enabled = false;
+
+void Profiler::Enable(bool enabled, int eventsPerThread)
+{
+	// capacidade potencia de 2 para indexar o buffer circular com mascara
+	int capacity = 1;
+	while(capacity < eventsPerThread)
+		capacity *= 2;
+
+	if(capacity != s_capacity)
+	{
+		for(int i = 0; i < PROFILER_THREADS; i++)
+		{
+			delete[] s_buffers[i]._events;
+			s_buffers[i]._events = 0;
+			s_buffers[i]._head = 0;
+		}
+		s_capacity = capacity;
+	}
+
+	s_enabled = enabled;
+}
+
+long long Profiler::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - s_origin).count();
+}
+
+void Profiler::Record(int thread, const char* name, long long begin, long long end)
+{
+	if(thread < 0 || thread >= PROFILER_THREADS)
+		return;
+
+	// apenas a propria thread grava no seu buffer, que e alocado no primeiro uso
+	Buffer& buffer = s_buffers[thread];
+	if(buffer._events == 0)
+		buffer._events = new Event[s_capacity];
+
+	unsigned int head = buffer._head.load(std::memory_order_relaxed);
+	Event& event = buffer._events[head & (s_capacity - 1)];
+	event.name = name;
+	event.begin = begin;
+	event.end = end;
+	buffer._head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::Clear()
+{
+	for(int i = 0; i < PROFILER_THREADS; i++)
+	{
+		s_buffers[i]._head = 0;
+	}
+}
+
+bool Profiler::Export(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if(file == 0)
+		return false;
+
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	bool first = true;
+	for(int t = 0; t < PROFILER_THREADS; t++)
+	{
+		Buffer& buffer = s_buffers[t];
+		unsigned int head = buffer._head.load(std::memory_order_acquire);
+		if(buffer._events == 0 || head == 0)
+			continue;
+
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+			first ? "" : ",\n", t, t);
+		first = false;
+
+		// somente os ultimos s_capacity eventos continuam no buffer
+		unsigned int count = head < (unsigned int)s_capacity ? head : (unsigned int)s_capacity;
+		for(unsigned int i = head - count; i != head; i++)
+		{
+			const Event& event = buffer._events[i & (s_capacity - 1)];
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, t, event.begin / 1000.0, (event.end - event.begin) / 1000.0);
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+}
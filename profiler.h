@@ -0,0 +1,90 @@
+// profiler.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+
+// Numero maximo de threads com buffer de eventos proprio
+#define PROFILER_THREADS 64
+
+// Medicao de trechos do codigo (zonas) para visualizacao no formato de
+// eventos do Chrome (chrome://tracing, Perfetto).
+// Cada thread grava apenas no seu buffer circular, indicado pelo indice de
+// thread do escalonador, entao a gravacao nao usa travas. Quando o buffer
+// enche os eventos mais antigos sao sobrescritos.
+// As zonas so existem quando PROFILER esta definido na compilacao; sem ele
+// PROFILE_ZONE nao gera codigo.
+class Profiler
+{
+public:
+	struct Event
+	{
+		const char* name;
+		long long begin;
+		long long end;
+	};
+
+	// Liga ou desliga a gravacao e define a capacidade de cada buffer.
+	// Deve ser chamado fora de um ParallelFor.
+	static void Enable(bool enabled, int eventsPerThread = 65536);
+	static bool Enabled() { return s_enabled; }
+
+	// Tempo em nanossegundos desde a primeira chamada
+	static long long Now();
+
+	// thread: indice em [0, PROFILER_THREADS); name deve ser uma string estatica
+	static void Record(int thread, const char* name, long long begin, long long end);
+
+	// Descarta os eventos gravados
+	static void Clear();
+
+	// Grava os eventos em formato JSON de eventos do Chrome.
+	// Deve ser chamado fora de um ParallelFor.
+	static bool Export(const char* path);
+
+private:
+	struct Buffer
+	{
+		Event* _events;
+		std::atomic<unsigned int> _head;
+	};
+
+	static Buffer s_buffers[PROFILER_THREADS];
+	static int s_capacity;
+	static bool s_enabled;
+};
+
+// Zona com escopo: mede do construtor ao destrutor
+class ProfileZone
+{
+public:
+	ProfileZone(const char* name, int thread)
+	{
+		_name = name;
+		_thread = thread;
+		_begin = Profiler::Enabled() ? Profiler::Now() : 0;
+	}
+
+	~ProfileZone()
+	{
+		if(Profiler::Enabled())
+			Profiler::Record(_thread, _name, _begin, Profiler::Now());
+	}
+
+private:
+	const char* _name;
+	int _thread;
+	long long _begin;
+};
+
+#ifdef PROFILER
+#define PROFILE_ZONE(name, thread) ProfileZone profileZone(name, thread)
+#else
+#define PROFILE_ZONE(name, thread)
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+// random.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "simd.h"
+#include "random.h"
+
+// constantes da funcao de mistura de 32 bits (lowbias32)
+#define MIX_MULTIPLIER0 0x7feb352du
+#define MIX_MULTIPLIER1 0x846ca68bu
+
+static inline unsigned int Mix(unsigned int x)
+{
+	x ^= x >> 16;
+	x *= MIX_MULTIPLIER0;
+	x ^= x >> 15;
+	x *= MIX_MULTIPLIER1;
+	x ^= x >> 16;
+	return x;
+}
+
+// SplitMix64, usado apenas para derivar as chaves
+static unsigned long long SplitMix(unsigned long long x)
+{
+	x += 0x9e3779b97f4a7c15ull;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+
+Random::Random(unsigned int seed, unsigned int stream)
+{
+	_seed = seed;
+	_stream = stream;
+	_counter = 0;
+
+	unsigned long long key = SplitMix(((unsigned long long)seed << 32) | stream);
+	_key0 = (unsigned int)key;
+	_key1 = (unsigned int)(key >> 32);
+}
+
+unsigned int Random::Bits(unsigned long long counter) const
+{
+	// a parte alta do contador altera a chave da segunda rodada
+	unsigned int key1 = Mix((unsigned int)(counter >> 32) ^ _key1);
+	return Mix(Mix((unsigned int)counter ^ _key0) + key1);
+}
+
+float Random::Uniform(unsigned long long counter) const
+{
+	// 24 bits: todos os valores sao exatos em float e menores que 1
+	return (float)(Bits(counter) >> 8) * (1.0f / 16777216.0f);
+}
+
+float Random::Next()
+{
+	return Uniform(_counter++);
+}
+
+#ifdef SIMD_SSE
+// Produto de 32 bits (parte baixa) em cada faixa; SSE2 so tem o produto
+// das faixas pares
+static inline __m128i MultiplyLow(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(
+		_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+		_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i Mix(__m128i x)
+{
+	const __m128i multiplier0 = _mm_set1_epi32((int)MIX_MULTIPLIER0);
+	const __m128i multiplier1 = _mm_set1_epi32((int)MIX_MULTIPLIER1);
+
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	x = MultiplyLow(x, multiplier0);
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+	x = MultiplyLow(x, multiplier1);
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	return x;
+}
+#endif
+
+void Random::Fill(unsigned long long counter, float* values, int count) const
+{
+	int i = 0;
+
+#ifdef SIMD_SSE
+	const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+	const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+
+	while(i + 4 <= count)
+	{
+		// trecho em que a parte alta do contador nao muda
+		unsigned int low = (unsigned int)(counter + i);
+		unsigned int high = (unsigned int)((counter + i) >> 32);
+		unsigned long long remaining = 0x100000000ull - low;
+		int end = count;
+		if(remaining < (unsigned long long)(count - i))
+			end = i + (int)remaining;
+		if(end - i < 4)
+			break;
+
+		__m128i key0 = _mm_set1_epi32((int)_key0);
+		__m128i key1 = _mm_set1_epi32((int)Mix(high ^ _key1));
+		__m128i index = _mm_add_epi32(_mm_set1_epi32((int)low), lanes);
+		const __m128i four = _mm_set1_epi32(4);
+
+		for(; i + 4 <= end; i += 4)
+		{
+			__m128i x = Mix(_mm_add_epi32(Mix(_mm_xor_si128(index, key0)), key1));
+			__m128 value = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 8)), scale);
+			_mm_storeu_ps(values + i, value);
+			index = _mm_add_epi32(index, four);
+		}
+	}
+#endif
+
+	for(; i < count; i++)
+	{
+		values[i] = Uniform(counter + i);
+	}
+}
@@ -0,0 +1,43 @@
+// random.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+// Gerador de numeros aleatorios baseado em contador. O numero de indice n de
+// um fluxo e uma funcao de mistura (hash de 32 bits em duas rodadas) de n e
+// de uma chave derivada da semente e do numero do fluxo, sem estado
+// compartilhado: qualquer trecho da sequencia pode ser gerado diretamente,
+// em qualquer ordem e por qualquer thread, com o mesmo resultado. Fluxos de
+// numeros diferentes (por exemplo, um por thread) sao independentes.
+// Dentro de cada bloco de 2^32 indices a funcao e uma permutacao, entao nao
+// ha repeticao antes de 2^32 numeros.
+class Random
+{
+public:
+	Random(unsigned int seed = 0, unsigned int stream = 0);
+
+	unsigned int _seed;
+	unsigned int _stream;
+	// indice do proximo numero entregue por Next
+	unsigned long long _counter;
+
+	// Numero de 32 bits de indice counter
+	unsigned int Bits(unsigned long long counter) const;
+	// Numero de indice counter em [0, 1)
+	float Uniform(unsigned long long counter) const;
+	// Proximo numero da sequencia em [0, 1)
+	float Next();
+
+	// Preenche values com os numeros de indices [counter, counter + count)
+	// em [0, 1); usa SSE2 quando disponivel
+	void Fill(unsigned long long counter, float* values, int count) const;
+
+private:
+	unsigned int _key0;
+	unsigned int _key1;
+};
+
+#endif
@@ -0,0 +1,99 @@
+// rungekutta4.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "vector.h"
+#include "simulation.h"
+#include "rungekutta4.h"
+
+// peso da derivada de cada estagio na soma e fracao do passo usada para
+// montar o estado do estagio seguinte
+static const float s_weight[4] = { 1.0f, 2.0f, 2.0f, 1.0f };
+static const float s_advance[4] = { 0.5f, 0.5f, 1.0f, 0.0f };
+
+RungeKutta4::RungeKutta4()
+{
+	_integratorType = RUNGE_KUTTA4;
+}
+
+int RungeKutta4::Stages() const
+{
+	return 4;
+}
+
+void RungeKutta4::Prepare(Simulation* simulation)
+{
+	int count = simulation->_store._count;
+	_position0.resize(count);
+	_velocity0.resize(count);
+	_positionSum.resize(count);
+	_velocitySum.resize(count);
+}
+
+inline void RungeKutta4::Stage::Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const
+{
+	Vector3& position0 = _position0[index];
+	Vector3& velocity0 = _velocity0[index];
+	Vector3& positionSum = _positionSum[index];
+	Vector3& velocitySum = _velocitySum[index];
+
+	// derivada do estagio: (velocidade, aceleracao) no estado atual
+	if(_stage == 0)
+	{
+		position0 = position;
+		velocity0 = velocity;
+		positionSum = velocity;
+		velocitySum = acceleration;
+	}
+	else
+	{
+		positionSum.x += _weight * velocity.x;
+		positionSum.y += _weight * velocity.y;
+		positionSum.z += _weight * velocity.z;
+		velocitySum.x += _weight * acceleration.x;
+		velocitySum.y += _weight * acceleration.y;
+		velocitySum.z += _weight * acceleration.z;
+	}
+
+	if(_stage < 3)
+	{
+		// estado em que o proximo estagio sera avaliado
+		float h = _advance * _timeStep;
+		Vector3 k = velocity;
+		position.x = position0.x + h * k.x;
+		position.y = position0.y + h * k.y;
+		position.z = position0.z + h * k.z;
+		velocity.x = velocity0.x + h * acceleration.x;
+		velocity.y = velocity0.y + h * acceleration.y;
+		velocity.z = velocity0.z + h * acceleration.z;
+	}
+	else
+	{
+		float h = _timeStep / 6.0f;
+		previous = position0;
+		position.x = position0.x + h * positionSum.x;
+		position.y = position0.y + h * positionSum.y;
+		position.z = position0.z + h * positionSum.z;
+		velocity.x = velocity0.x + h * velocitySum.x;
+		velocity.y = velocity0.y + h * velocitySum.y;
+		velocity.z = velocity0.z + h * velocitySum.z;
+	}
+}
+
+void RungeKutta4::Integrate(ParticleStore* store, int stage, int begin, int end)
+{
+	if(begin >= end)
+		return;
+
+	Stage policy;
+	policy._position0 = &_position0[0];
+	policy._velocity0 = &_velocity0[0];
+	policy._positionSum = &_positionSum[0];
+	policy._velocitySum = &_velocitySum[0];
+	policy._stage = stage;
+	policy._weight = s_weight[stage];
+	policy._advance = s_advance[stage];
+	policy._timeStep = _fixedTimeStep;
+	IntegrateRange(policy, store, begin, end);
+}
@@ -0,0 +1,48 @@
+// rungekutta4.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef RUNGEKUTTA4_H
+#define RUNGEKUTTA4_H
+
+#include <vector>
+
+#include "integrator.h"
+
+// Runge-Kutta classico de quarta ordem, com quatro avaliacoes de forca por
+// passo. O estado inicial e a soma ponderada das derivadas de cada estagio
+// ficam em buffers por particula; a cada estagio o store recebe o estado
+// intermediario em que as forcas do estagio seguinte serao avaliadas.
+class RungeKutta4 : public Integrator
+{
+public:
+	RungeKutta4();
+
+	// estado no inicio do passo
+	std::vector<Vector3> _position0;
+	std::vector<Vector3> _velocity0;
+	// soma ponderada das derivadas (k1 + 2 k2 + 2 k3 + k4)
+	std::vector<Vector3> _positionSum;
+	std::vector<Vector3> _velocitySum;
+
+	int Stages() const;
+	void Prepare(Simulation* simulation);
+	void Integrate(ParticleStore* store, int stage, int begin, int end);
+
+	// politica de um estagio para IntegrateRange
+	struct Stage
+	{
+		Vector3* _position0;
+		Vector3* _velocity0;
+		Vector3* _positionSum;
+		Vector3* _velocitySum;
+		int _stage;
+		float _weight;
+		float _advance;
+		float _timeStep;
+		void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
+	};
+};
+
+#endif
@@ -0,0 +1,292 @@
+// scene.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <string.h>
+
+#include "gravity.h"
+#include "medium.h"
+#include "simulation.h"
+#include "scene.h"
+
+bool Scene::Load(Simulation* simulation, const char* name, int size)
+{
+	if(strcmp(name, "rain") == 0)
+		AddRain(simulation, size > 0 ? size : 250);
+	else if(strcmp(name, "fountain") == 0)
+		AddFountain(simulation, size > 0 ? size : 1000);
+	else if(strcmp(name, "cube") == 0)
+		AddCubes(simulation, size > 0 ? size : 1);
+	else if(strcmp(name, "cloth") == 0)
+		AddCloth(simulation, size > 0 ? size : 15);
+	else if(strcmp(name, "drape") == 0)
+		AddDrape(simulation, size > 0 ? size : 30);
+	else if(strcmp(name, "bowl") == 0)
+		AddBowl(simulation, size > 0 ? size : 250);
+	else if(strcmp(name, "terrain") == 0)
+		AddTerrain(simulation, size > 0 ? size : 15);
+	else
+		return false;
+
+	AddBox(simulation);
+
+	Gravity* gravity = new Gravity();
+	simulation->AddForceGenerator((ForceGenerator*)gravity);
+
+	/*Medium* air = new Medium(0.50f);
+	simulation->AddForceGenerator((ForceGenerator*)air);*/
+
+	simulation->_integrator = new Euler();
+
+	/*simulation->_integrator = new Verlet();*/
+
+	return true;
+}
+
+Integrator* Scene::CreateIntegrator(const char* name)
+{
+	if(strcmp(name, "euler") == 0)
+		return new Euler();
+	if(strcmp(name, "verlet") == 0)
+		return new Verlet();
+	if(strcmp(name, "symplectic") == 0)
+		return new SymplecticEuler();
+	if(strcmp(name, "leapfrog") == 0)
+		return new Leapfrog();
+	if(strcmp(name, "rk4") == 0)
+		return new RungeKutta4();
+	if(strcmp(name, "implicit") == 0)
+		return new ImplicitEuler();
+	return 0;
+}
+
+void Scene::AddBox(Simulation* simulation)
+{
+	//
+	// Criando caixa a partir de planos
+	//
+	float size = 3.0f;
+
+	float planeR = 0.5f;
+	float planeG = 0.5f;
+	float planeB = 0.5f;
+
+	// Plane Bottom
+	Vector3 normal0 = Vector3(0.0f, 1.0f, 0.0f);
+	Vector3 position0 = Vector3(0.0f, 0.0f, 0.0f);
+
+	Plane* plane0 = new Plane();
+	plane0->Initialize(size, normal0, position0, planeR, planeG, planeB);
+	simulation->AddPlane(plane0);
+
+	// Plane Right
+	Vector3 normal1 = Vector3(-1.0f, 0.0f, 0.0f);
+	Vector3 position1 = Vector3(size, size, 0.0f);
+
+	Plane* plane1 = new Plane();
+	plane1->Initialize(size, normal1, position1, planeR, planeG, planeB);
+	simulation->AddPlane(plane1);
+
+	// Plane Left
+	Vector3 normal2 = Vector3(1.0f, 0.0f, 0.0f);
+	Vector3 position2 = Vector3(-size, size, 0.0f);
+
+	Plane* plane2 = new Plane();
+	plane2->Initialize(size, normal2, position2, planeR, planeG, planeB);
+	simulation->AddPlane(plane2);
+
+	// Plane Front
+	Vector3 normal3 = Vector3(0.0f, 0.0f, -1.0f);
+	Vector3 position3 = Vector3(0.0f, size, size);
+
+	Plane* plane3 = new Plane();
+	plane3->Initialize(size, normal3, position3, planeR, planeG, planeB);
+	simulation->AddPlane(plane3);
+
+	// Plane Back
+	Vector3 normal4 = Vector3(0.0f, 0.0f, 1.0f);
+	Vector3 position4 = Vector3(0.0f, size, -size);
+
+	Plane* plane4 = new Plane();
+	plane4->Initialize(size, normal4, position4, planeR, planeG, planeB);
+	simulation->AddPlane(plane4);
+}
+
+void Scene::AddRain(Simulation* simulation, int particles)
+{
+	// Particle Generator
+	float genMass = 10.0f;
+	float genRadius = 0.5f;
+	float genX = 0.0f;
+	float genY = 25.0f;
+	float genZ = 0.0f;
+
+	ParticleGenerator* generator = new ParticleGenerator();
+	generator->Initialize(genMass, genRadius, particles, genX, genY, genZ);
+	simulation->AddParticleGenerator(generator);
+
+// 	// Particle
+// 	float particleMass = 100.0f;
+// 	float particleRadius = 2.5f;
+// 	float particleX = 0.0f;
+// 	float particleY = 2.5f;
+// 	float particleZ = 0.0f;
+// 	float particleR = 1.0f;
+// 	float particleG = 0.0f;
+// 	float particleB = 0.0f;
+//
+// 	Particle* particle = new Particle();
+// 	particle->Initialize(particleMass, particleRadius, particleX, particleY, particleZ, particleR, particleG, particleB, Particle::ParticleType::PASSIVE);
+// 	simulation->AddParticle(particle);
+}
+
+void Scene::AddFountain(Simulation* simulation, int particles)
+{
+	// jato vertical; cada gota vive 3 s e o anel fica praticamente cheio
+	float lifetime = 3.0f;
+
+	ParticleGenerator* generator = new ParticleGenerator();
+	generator->Initialize(1.0f, 0.1f, particles, 0.0f, 0.5f, 0.0f);
+	generator->_burst = 0;
+	generator->_rate = particles / lifetime;
+	generator->_lifetime = lifetime;
+	generator->_extent = Vector3(0.2f, 0.0f, 0.2f);
+	generator->_velocity = Vector3(0.0f, 12.0f, 0.0f);
+	generator->_spread = Vector3(1.5f, 2.0f, 1.5f);
+	simulation->AddParticleGenerator(generator);
+}
+
+void Scene::AddDrape(Simulation* simulation, int resolution)
+{
+	// bola grande sob o pano: raios 25 vezes diferentes
+	float ballMass = 100.0f;
+	float ballRadius = 2.5f;
+
+	Particle ball;
+	ball.Initialize(ballMass, ballRadius, 0.0f, ballRadius, 0.0f, 1.0f, 0.0f, 0.0f, Particle::ParticleType::ACTIVE);
+	simulation->AddParticle(&ball);
+
+	AddCloth(simulation, resolution);
+}
+
+void Scene::AddBowl(Simulation* simulation, int particles)
+{
+	// bacia: semiespaco y <= 2 escavado por uma esfera; o fundo tem 0.4 de
+	// espessura acima do chao. A resposta empurra ao longo do gradiente, e
+	// um bloco com face inferior e faces laterais devolveria pelo lado de
+	// baixo uma gota (raio 0.5) que passasse do meio do fundo, contra o chao,
+	// que a empurra de volta. Sem essas faces o solido e espesso para baixo e
+	// para os lados (a caixa de planos limita a cena) e o gradiente aponta
+	// sempre para a cavidade ou para cima
+	float spacing = 0.1f;
+	Vector3 center = Vector3(0.0f, 3.3f, 0.0f);
+	float radius = 2.9f;
+
+	SdfCollider* bowl = new SdfCollider();
+	bowl->Initialize(Vector3(-3.2f, -0.2f, -3.2f), spacing, 65, 25, 65, 0.6f, 0.4f, 0.2f);
+	bowl->Sample([&](const Vector3& p)
+	{
+		float block = p.y - 2.0f;
+
+		Vector3 d = p;
+		d -= center;
+		float sphere = d.Length() - radius;
+		return block > -sphere ? block : -sphere;
+	});
+	simulation->AddCollider(bowl);
+
+	AddRain(simulation, particles);
+}
+
+void Scene::AddTerrain(Simulation* simulation, int resolution)
+{
+	// colina em malha de triangulos: altura 2 exp(-(x^2 + z^2) / 2) sobre
+	// [-3, 3] x [-3, 3], em 32 x 32 quadrados
+	int cells = 32;
+	float size = 3.0f;
+
+	std::vector<Vector3> vertices;
+	std::vector<int> indices;
+	for(int j = 0; j <= cells; j++)
+	{
+		for(int i = 0; i <= cells; i++)
+		{
+			float x = -size + 2.0f * size * i / cells;
+			float z = -size + 2.0f * size * j / cells;
+			vertices.push_back(Vector3(x, 2.0f * expf(-0.5f * (x * x + z * z)), z));
+		}
+	}
+	for(int j = 0; j < cells; j++)
+	{
+		for(int i = 0; i < cells; i++)
+		{
+			int v = j * (cells + 1) + i;
+			indices.push_back(v);
+			indices.push_back(v + cells + 1);
+			indices.push_back(v + 1);
+			indices.push_back(v + 1);
+			indices.push_back(v + cells + 1);
+			indices.push_back(v + cells + 2);
+		}
+	}
+
+	MeshCollider* terrain = new MeshCollider();
+	terrain->_red = 0.3f;
+	terrain->_green = 0.6f;
+	terrain->_blue = 0.3f;
+	// o pano chega a 0.8 por passo
+	terrain->_thickness = 1.0f;
+	terrain->Build(vertices, indices);
+	simulation->AddMesh(terrain);
+
+	AddCloth(simulation, resolution);
+}
+
+void Scene::AddCubes(Simulation* simulation, int cubes)
+{
+	// Cube
+	float cubeMass = 2.0f;
+	float cubeRadius = 0.1f;
+	float xMin = -2.0f;
+	float xMax = +0.0f;
+	float yMin = 13.0f;
+	float yMax = 15.0f;
+	float zMin = -1.0f;
+	float zMax = +1.0f;
+	float cubeR = 0.0f;
+	float cubeG = 1.0f;
+	float cubeB = 0.0f;
+
+	// cubos adicionais sao empilhados acima do primeiro
+	simulation->Reserve(simulation->_store._count + cubes * VERTICES, 0, 0);
+	for(int i = 0; i < cubes; i++)
+	{
+		float offset = 3.0f * i;
+
+		Cube* cube = new Cube();
+		cube->Initialize(cubeMass, cubeRadius, xMin, xMax, yMin + offset, yMax + offset, zMin, zMax,
+			cubeR, cubeG, cubeB, Particle::ParticleType::ACTIVE);
+		simulation->AddCube(cube);
+	}
+}
+
+void Scene::AddCloth(Simulation* simulation, int resolution)
+{
+	// Cloth
+	float clothMass = 100.0f;
+	float clothRadius = 0.1f;
+	int nU = resolution;
+	int nV = resolution;
+	Vector3 p = Vector3(3.0f, 15.0f, 3.0f);
+	Vector3 pU = Vector3(-3.0f, 15.0f, 3.0f);
+	Vector3 pV = Vector3(3.0f, 15.0f, -3.0f);
+	float clothR = 0.0f;
+	float clothG = 0.0f;
+	float clothB = 1.0f;
+
+	Cloth* cloth = new Cloth();
+	cloth->Initialize(clothMass, clothRadius, nU, nV, p, pU, pV, clothR, clothG, clothB, Particle::ParticleType::ACTIVE);
+	simulation->AddCloth(cloth);
+}
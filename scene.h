@@ -0,0 +1,42 @@
+// scene.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SCENE_H
+#define SCENE_H
+
+class Simulation;
+class Integrator;
+
+class Scene
+{
+public:
+	// Monta uma cena na simulacao: a caixa de planos, a gravidade, o
+	// integrador e os objetos da cena.
+	// name: "rain" (rajada do gerador de particulas), "fountain" (emissao
+	//       continua), "cube", "cloth", "drape" (pano sobre uma bola
+	//       grande), "bowl" (chuva em uma bacia SDF) ou "terrain" (pano
+	//       sobre uma colina em malha de triangulos)
+	// size: particulas da chuva (tambem na bacia) ou do anel da fonte,
+	//       numero de cubos ou resolucao do pano (tambem na colina); 0 usa
+	//       o valor padrao da cena
+	// Retorna false se a cena nao existe.
+	static bool Load(Simulation* simulation, const char* name, int size = 0);
+
+	// Cria um integrador pelo nome: "euler", "verlet", "symplectic",
+	// "leapfrog", "rk4" ou "implicit". Retorna 0 se o nome nao existe.
+	static Integrator* CreateIntegrator(const char* name);
+
+private:
+	static void AddBox(Simulation* simulation);
+	static void AddRain(Simulation* simulation, int particles);
+	static void AddFountain(Simulation* simulation, int particles);
+	static void AddCubes(Simulation* simulation, int cubes);
+	static void AddCloth(Simulation* simulation, int resolution);
+	static void AddDrape(Simulation* simulation, int resolution);
+	static void AddBowl(Simulation* simulation, int particles);
+	static void AddTerrain(Simulation* simulation, int resolution);
+};
+
+#endif
@@ -0,0 +1,184 @@
+// scheduler.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "scheduler.h"
+
+Scheduler::Scheduler()
+{
+	_threadCount = 1;
+	_body = 0;
+	_generation = 0;
+	_quit = false;
+	_pending = 0;
+	_busy = 0;
+
+	_workers.push_back(new Worker());
+}
+
+Scheduler::~Scheduler()
+{
+	Shutdown();
+}
+
+void Scheduler::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_quit = true;
+	}
+	_wake.notify_all();
+
+	for(int i = 0; i < (int)_threads.size(); i++)
+	{
+		_threads[i].join();
+	}
+	_threads.clear();
+
+	for(int i = 0; i < (int)_workers.size(); i++)
+	{
+		delete _workers[i];
+	}
+	_workers.clear();
+
+	_quit = false;
+}
+
+void Scheduler::Initialize(int threadCount)
+{
+	Shutdown();
+
+	if(threadCount < 1)
+		threadCount = 1;
+	_threadCount = threadCount;
+
+	for(int i = 0; i < _threadCount; i++)
+	{
+		_workers.push_back(new Worker());
+	}
+
+	// a thread que chama ParallelFor e a thread 0
+	for(int i = 1; i < _threadCount; i++)
+	{
+		_threads.push_back(std::thread(&Scheduler::WorkerLoop, this, i));
+	}
+}
+
+bool Scheduler::PopTask(int thread, Task& task)
+{
+	// primeiro a propria fila, pelo fim
+	{
+		Worker* worker = _workers[thread];
+		std::lock_guard<std::mutex> lock(worker->_lock);
+		if(!worker->_tasks.empty())
+		{
+			task = worker->_tasks.back();
+			worker->_tasks.pop_back();
+			return true;
+		}
+	}
+
+	// depois rouba do inicio da fila das outras threads
+	for(int i = 1; i < _threadCount; i++)
+	{
+		Worker* victim = _workers[(thread + i) % _threadCount];
+		std::lock_guard<std::mutex> lock(victim->_lock);
+		if(!victim->_tasks.empty())
+		{
+			task = victim->_tasks.front();
+			victim->_tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Scheduler::RunTasks(int thread)
+{
+	Task task;
+	while(PopTask(thread, task))
+	{
+		(*_body)(task.begin, task.end, thread);
+
+		if(--_pending == 0)
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_done.notify_all();
+		}
+	}
+}
+
+void Scheduler::WorkerLoop(int thread)
+{
+	int generation = 0;
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			while(!_quit && _generation == generation)
+				_wake.wait(lock);
+			if(_quit)
+				return;
+			generation = _generation;
+			_busy++;
+		}
+
+		RunTasks(thread);
+
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_busy--;
+			_done.notify_all();
+		}
+	}
+}
+
+void Scheduler::ParallelFor(int begin, int end, int chunk, const Body& body)
+{
+	if(end <= begin)
+		return;
+	if(chunk < 1)
+		chunk = 1;
+
+	// execucao sequencial e deterministica
+	if(_threadCount == 1)
+	{
+		for(int i = begin; i < end; i += chunk)
+		{
+			body(i, i + chunk < end ? i + chunk : end, 0);
+		}
+		return;
+	}
+
+	_body = &body;
+	_pending += (end - begin + chunk - 1) / chunk;
+
+	// distribui os blocos entre as filas em rodizio
+	int chunks = 0;
+	for(int i = begin; i < end; i += chunk)
+	{
+		Task task;
+		task.begin = i;
+		task.end = i + chunk < end ? i + chunk : end;
+
+		Worker* worker = _workers[chunks % _threadCount];
+		std::lock_guard<std::mutex> lock(worker->_lock);
+		worker->_tasks.push_back(task);
+		chunks++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_generation++;
+	}
+	_wake.notify_all();
+
+	RunTasks(0);
+
+	// espera os blocos restantes e as threads que ainda estao trabalhando
+	std::unique_lock<std::mutex> lock(_lock);
+	while(_pending > 0 || _busy > 0)
+		_done.wait(lock);
+}
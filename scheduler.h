@@ -0,0 +1,70 @@
+// scheduler.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+// Escalonador de tarefas com um conjunto fixo de threads. Cada thread tem
+// sua propria fila; a thread dona consome do fim da sua fila e, quando ela
+// esvazia, rouba do inicio da fila das demais.
+// Com uma unica thread (padrao) os blocos sao executados em ordem na thread
+// que chamou, o que torna a simulacao deterministica.
+class Scheduler
+{
+public:
+	// begin, end: intervalo do bloco; thread: indice da thread em [0, _threadCount)
+	typedef std::function<void(int begin, int end, int thread)> Body;
+
+	Scheduler();
+	~Scheduler();
+
+	int _threadCount;
+
+	void Initialize(int threadCount);
+	void ParallelFor(int begin, int end, int chunk, const Body& body);
+
+private:
+	struct Task
+	{
+		int begin;
+		int end;
+	};
+
+	struct Worker
+	{
+		std::mutex _lock;
+		std::deque<Task> _tasks;
+	};
+
+	std::vector<Worker*> _workers;
+	std::vector<std::thread> _threads;
+
+	std::mutex _lock;
+	std::condition_variable _wake;
+	std::condition_variable _done;
+	const Body* _body;
+	int _generation;
+	bool _quit;
+	std::atomic<int> _pending;
+	std::atomic<int> _busy;
+
+	void Shutdown();
+	void WorkerLoop(int thread);
+	void RunTasks(int thread);
+	bool PopTask(int thread, Task& task);
+
+	Scheduler(const Scheduler&);
+	Scheduler& operator= (const Scheduler&);
+};
+
+#endif
@@ -0,0 +1,302 @@
+// sdfcollider.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <string.h>
+
+#include "graphics.h"
+
+#include "simd.h"
+#include "particlestore.h"
+#include "sdfcollider.h"
+
+SdfCollider::SdfCollider()
+{
+	_origin = Vector3(0.0f, 0.0f, 0.0f);
+	_spacing = 1.0f;
+	_nx = _ny = _nz = 0;
+	_red = _green = _blue = 0.5f;
+}
+
+SdfCollider::~SdfCollider()
+{
+}
+
+void SdfCollider::Initialize(Vector3 origin, float spacing, int nx, int ny, int nz, float r, float g, float b)
+{
+	_origin = origin;
+	_spacing = spacing;
+	_nx = nx;
+	_ny = ny;
+	_nz = nz;
+	_red = r;
+	_green = g;
+	_blue = b;
+	_distance.assign(nx * ny * nz, 0.0f);
+	_surfaceCoord.clear();
+	_surfaceColor.clear();
+}
+
+void SdfCollider::SetSamples(const float* values)
+{
+	if(!_distance.empty())
+		memcpy(&_distance[0], values, _distance.size() * sizeof(float));
+	UpdateSurface();
+}
+
+void SdfCollider::UpdateSurface()
+{
+	_surfaceCoord.clear();
+	_surfaceColor.clear();
+	for(int z = 0; z < _nz; z++)
+	{
+		for(int y = 0; y < _ny; y++)
+		{
+			for(int x = 0; x < _nx; x++)
+			{
+				if(fabsf(_distance[(z * _ny + y) * _nx + x]) > 0.5f * _spacing)
+					continue;
+
+				_surfaceCoord.push_back(_origin.x + x * _spacing);
+				_surfaceCoord.push_back(_origin.y + y * _spacing);
+				_surfaceCoord.push_back(_origin.z + z * _spacing);
+				_surfaceColor.push_back(_red);
+				_surfaceColor.push_back(_green);
+				_surfaceColor.push_back(_blue);
+			}
+		}
+	}
+}
+
+bool SdfCollider::Query(const Vector3& point, float& distance, Vector3& normal) const
+{
+	float scale = 1.0f / _spacing;
+	float gx = (point.x - _origin.x) * scale;
+	float gy = (point.y - _origin.y) * scale;
+	float gz = (point.z - _origin.z) * scale;
+	if(!(gx >= 0.0f && gx < (float)(_nx - 1) &&
+		gy >= 0.0f && gy < (float)(_ny - 1) &&
+		gz >= 0.0f && gz < (float)(_nz - 1)))
+		return false;
+
+	int ix = (int)gx;
+	int iy = (int)gy;
+	int iz = (int)gz;
+	float fx = gx - (float)ix;
+	float fy = gy - (float)iy;
+	float fz = gz - (float)iz;
+
+	// amostras da celula
+	int sy = _nx;
+	int sz = _nx * _ny;
+	const float* c = &_distance[(iz * _ny + iy) * _nx + ix];
+	float c000 = c[0], c100 = c[1], c010 = c[sy], c110 = c[sy+1];
+	float c001 = c[sz], c101 = c[sz+1], c011 = c[sz+sy], c111 = c[sz+sy+1];
+
+	// interpolacao em x, y e z; o gradiente e a derivada do mesmo polinomio
+	float a00 = c000 + (c100 - c000) * fx;
+	float a10 = c010 + (c110 - c010) * fx;
+	float a01 = c001 + (c101 - c001) * fx;
+	float a11 = c011 + (c111 - c011) * fx;
+	float b0 = a00 + (a10 - a00) * fy;
+	float b1 = a01 + (a11 - a01) * fy;
+	distance = b0 + (b1 - b0) * fz;
+
+	float e0 = (c100 - c000) + ((c110 - c010) - (c100 - c000)) * fy;
+	float e1 = (c101 - c001) + ((c111 - c011) - (c101 - c001)) * fy;
+	float dx = e0 + (e1 - e0) * fz;
+	float dy = (a10 - a00) + ((a11 - a01) - (a10 - a00)) * fz;
+	float dz = b1 - b0;
+
+	float length = sqrtf(dx * dx + dy * dy + dz * dz);
+	if(!(length > 0.0f))
+		return false;
+	normal = Vector3(dx / length, dy / length, dz / length);
+	return true;
+}
+
+void SdfCollider::CollideScalar(ParticleStore* store, float dissipative, int begin, int end) const
+{
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+	float* radius = store->_radius;
+	Particle::ParticleType* type = store->_particleType;
+
+	for(int i = begin; i < end; i++)
+	{
+		if(type[i] == Particle::SLEEPING)
+			continue;
+
+		float distance;
+		Vector3 normal;
+		if(!Query(position[i], distance, normal))
+			continue;
+
+		distance -= radius[i];
+
+		if(distance < 0.0f)
+		{
+			Vector3 t = normal;
+			t *= -distance;
+			position[i] += t;
+
+			t = normal;
+			t *= Dot(velocity[i], normal);
+
+			t *= 2.0f;
+
+			velocity[i] -= t;
+
+			velocity[i] *= dissipative;
+		}
+	}
+}
+
+void SdfCollider::Collide(ParticleStore* store, float dissipative, int begin, int end) const
+{
+	int i = begin;
+
+#ifdef SIMD_SSE
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+	float* radius = store->_radius;
+	Particle::ParticleType* type = store->_particleType;
+	const float* samples = _distance.empty() ? 0 : &_distance[0];
+	int sy = _nx;
+	int sz = _nx * _ny;
+
+	SIMD_ALIGN(16) int cell[3][4];
+	SIMD_ALIGN(16) float px[4], py[4], pz[4];
+	SIMD_ALIGN(16) float vx[4], vy[4], vz[4];
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 dissipation = _mm_set1_ps(dissipative);
+	const __m128 scale = _mm_set1_ps(1.0f / _spacing);
+	const __m128 originX = _mm_set1_ps(_origin.x);
+	const __m128 originY = _mm_set1_ps(_origin.y);
+	const __m128 originZ = _mm_set1_ps(_origin.z);
+	const __m128 limitX = _mm_set1_ps((float)(_nx - 1));
+	const __m128 limitY = _mm_set1_ps((float)(_ny - 1));
+	const __m128 limitZ = _mm_set1_ps((float)(_nz - 1));
+	const __m128i sleeping = _mm_set1_epi32(Particle::SLEEPING);
+
+	for(; i + 4 <= end; i += 4)
+	{
+		__m128 x, y, z;
+		SimdLoad3(&position[i].x, x, y, z);
+
+		// coordenadas na grade; faixas fora da grade ficam na celula 0
+		__m128 gx = _mm_mul_ps(_mm_sub_ps(x, originX), scale);
+		__m128 gy = _mm_mul_ps(_mm_sub_ps(y, originY), scale);
+		__m128 gz = _mm_mul_ps(_mm_sub_ps(z, originZ), scale);
+		__m128 inside = _mm_and_ps(
+			_mm_and_ps(_mm_and_ps(_mm_cmpge_ps(gx, zero), _mm_cmplt_ps(gx, limitX)),
+				_mm_and_ps(_mm_cmpge_ps(gy, zero), _mm_cmplt_ps(gy, limitY))),
+			_mm_and_ps(_mm_cmpge_ps(gz, zero), _mm_cmplt_ps(gz, limitZ)));
+		if(_mm_movemask_ps(inside) == 0)
+			continue;
+
+		gx = _mm_and_ps(inside, gx);
+		gy = _mm_and_ps(inside, gy);
+		gz = _mm_and_ps(inside, gz);
+		__m128i ix = _mm_cvttps_epi32(gx);
+		__m128i iy = _mm_cvttps_epi32(gy);
+		__m128i iz = _mm_cvttps_epi32(gz);
+		__m128 fx = _mm_sub_ps(gx, _mm_cvtepi32_ps(ix));
+		__m128 fy = _mm_sub_ps(gy, _mm_cvtepi32_ps(iy));
+		__m128 fz = _mm_sub_ps(gz, _mm_cvtepi32_ps(iz));
+
+		// amostras das 8 celulas; SSE2 nao tem leitura indexada
+		_mm_store_si128((__m128i*)cell[0], ix);
+		_mm_store_si128((__m128i*)cell[1], iy);
+		_mm_store_si128((__m128i*)cell[2], iz);
+		const float* c[4];
+		for(int k = 0; k < 4; k++)
+		{
+			c[k] = samples + (cell[2][k] * _ny + cell[1][k]) * _nx + cell[0][k];
+		}
+		__m128 c000 = _mm_set_ps(c[3][0], c[2][0], c[1][0], c[0][0]);
+		__m128 c100 = _mm_set_ps(c[3][1], c[2][1], c[1][1], c[0][1]);
+		__m128 c010 = _mm_set_ps(c[3][sy], c[2][sy], c[1][sy], c[0][sy]);
+		__m128 c110 = _mm_set_ps(c[3][sy+1], c[2][sy+1], c[1][sy+1], c[0][sy+1]);
+		__m128 c001 = _mm_set_ps(c[3][sz], c[2][sz], c[1][sz], c[0][sz]);
+		__m128 c101 = _mm_set_ps(c[3][sz+1], c[2][sz+1], c[1][sz+1], c[0][sz+1]);
+		__m128 c011 = _mm_set_ps(c[3][sz+sy], c[2][sz+sy], c[1][sz+sy], c[0][sz+sy]);
+		__m128 c111 = _mm_set_ps(c[3][sz+sy+1], c[2][sz+sy+1], c[1][sz+sy+1], c[0][sz+sy+1]);
+
+		// mesmas operacoes de Query
+		__m128 d100 = _mm_sub_ps(c100, c000);
+		__m128 d110 = _mm_sub_ps(c110, c010);
+		__m128 d101 = _mm_sub_ps(c101, c001);
+		__m128 d111 = _mm_sub_ps(c111, c011);
+		__m128 a00 = _mm_add_ps(c000, _mm_mul_ps(d100, fx));
+		__m128 a10 = _mm_add_ps(c010, _mm_mul_ps(d110, fx));
+		__m128 a01 = _mm_add_ps(c001, _mm_mul_ps(d101, fx));
+		__m128 a11 = _mm_add_ps(c011, _mm_mul_ps(d111, fx));
+		__m128 b0 = _mm_add_ps(a00, _mm_mul_ps(_mm_sub_ps(a10, a00), fy));
+		__m128 b1 = _mm_add_ps(a01, _mm_mul_ps(_mm_sub_ps(a11, a01), fy));
+		__m128 distance = _mm_add_ps(b0, _mm_mul_ps(_mm_sub_ps(b1, b0), fz));
+
+		__m128 e0 = _mm_add_ps(d100, _mm_mul_ps(_mm_sub_ps(d110, d100), fy));
+		__m128 e1 = _mm_add_ps(d101, _mm_mul_ps(_mm_sub_ps(d111, d101), fy));
+		__m128 dx = _mm_add_ps(e0, _mm_mul_ps(_mm_sub_ps(e1, e0), fz));
+		__m128 dya = _mm_sub_ps(a10, a00);
+		__m128 dy = _mm_add_ps(dya, _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(a11, a01), dya), fz));
+		__m128 dz = _mm_sub_ps(b1, b0);
+
+		__m128i types = _mm_set_epi32(type[i+3], type[i+2], type[i+1], type[i]);
+		__m128 active = _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(types, sleeping), _mm_set1_epi32(-1)));
+
+		distance = _mm_sub_ps(distance, _mm_loadu_ps(radius + i));
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		__m128 hit = _mm_and_ps(_mm_and_ps(inside, active),
+			_mm_and_ps(_mm_cmpgt_ps(length, zero), _mm_cmplt_ps(distance, zero)));
+		int lanes = _mm_movemask_ps(hit);
+		if(lanes == 0)
+			continue;
+
+		__m128 nx = _mm_div_ps(dx, length);
+		__m128 ny = _mm_div_ps(dy, length);
+		__m128 nz = _mm_div_ps(dz, length);
+
+		__m128 depth = _mm_sub_ps(zero, distance);
+		x = _mm_add_ps(x, _mm_mul_ps(nx, depth));
+		y = _mm_add_ps(y, _mm_mul_ps(ny, depth));
+		z = _mm_add_ps(z, _mm_mul_ps(nz, depth));
+
+		__m128 u, v, w;
+		SimdLoad3(&velocity[i].x, u, v, w);
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(u, nx), _mm_mul_ps(v, ny)), _mm_mul_ps(w, nz));
+		u = _mm_mul_ps(_mm_sub_ps(u, _mm_mul_ps(_mm_mul_ps(nx, dot), two)), dissipation);
+		v = _mm_mul_ps(_mm_sub_ps(v, _mm_mul_ps(_mm_mul_ps(ny, dot), two)), dissipation);
+		w = _mm_mul_ps(_mm_sub_ps(w, _mm_mul_ps(_mm_mul_ps(nz, dot), two)), dissipation);
+
+		// devolve apenas as particulas que penetraram
+		_mm_store_ps(px, x);
+		_mm_store_ps(py, y);
+		_mm_store_ps(pz, z);
+		_mm_store_ps(vx, u);
+		_mm_store_ps(vy, v);
+		_mm_store_ps(vz, w);
+		for(int k = 0; k < 4; k++)
+		{
+			if((lanes & (1 << k)) == 0)
+				continue;
+			position[i+k] = Vector3(px[k], py[k], pz[k]);
+			velocity[i+k] = Vector3(vx[k], vy[k], vz[k]);
+		}
+	}
+#endif
+
+	CollideScalar(store, dissipative, i, end);
+}
+
+void SdfCollider::Draw()
+{
+	int count = (int)_surfaceCoord.size() / 3;
+	if(count > 0)
+		Graphics::DrawPointParticles(count, 2.0f, &_surfaceCoord[0], &_surfaceColor[0]);
+}
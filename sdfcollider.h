@@ -0,0 +1,82 @@
+// sdfcollider.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SDFCOLLIDER_H
+#define SDFCOLLIDER_H
+
+#include <vector>
+
+#include "vector.h"
+
+class ParticleStore;
+
+// Obstaculo estatico descrito por uma funcao distancia com sinal (negativa
+// dentro do solido) amostrada em uma grade regular na carga da cena. Permite
+// geometria arbitraria (bacias, terreno, obstaculos) sem testes por
+// triangulo: a distancia e o gradiente em um ponto vem da interpolacao
+// trilinear das 8 amostras da celula. Pontos fora da grade nao colidem.
+// A resposta e a mesma dos planos: a particula que penetra e empurrada para
+// fora ao longo do gradiente e tem a velocidade refletida e multiplicada
+// pelo fator dissipativo.
+class SdfCollider
+{
+public:
+	SdfCollider();
+	~SdfCollider();
+
+	// canto minimo da grade, espacamento e amostras por eixo
+	Vector3 _origin;
+	float _spacing;
+	int _nx, _ny, _nz;
+	// amostras com x variando mais rapido
+	std::vector<float> _distance;
+	float _red, _green, _blue;
+
+	// Reserva a grade de nx x ny x nz amostras a partir de origin
+	void Initialize(Vector3 origin, float spacing, int nx, int ny, int nz, float r, float g, float b);
+
+	// Amostra distance(ponto) em cada no da grade
+	template <class F>
+	void Sample(F distance)
+	{
+		for(int z = 0; z < _nz; z++)
+		{
+			for(int y = 0; y < _ny; y++)
+			{
+				for(int x = 0; x < _nx; x++)
+				{
+					Vector3 point(_origin.x + x * _spacing, _origin.y + y * _spacing, _origin.z + z * _spacing);
+					_distance[(z * _ny + y) * _nx + x] = distance(point);
+				}
+			}
+		}
+		UpdateSurface();
+	}
+
+	// Copia as amostras de values (nx * ny * nz valores)
+	void SetSamples(const float* values);
+
+	// Distancia e normal (gradiente normalizado) em point; retorna false fora
+	// da grade ou onde o gradiente se anula
+	bool Query(const Vector3& point, float& distance, Vector3& normal) const;
+
+	// Colisao das particulas [begin, end) com o obstaculo. Particulas
+	// adormecidas sao ignoradas. Com SSE as particulas sao processadas em
+	// lotes de 4, com a resposta aplicada por mascara; o resultado e o mesmo
+	// do caminho escalar.
+	void Collide(ParticleStore* store, float dissipative, int begin, int end) const;
+
+	void Draw();
+
+private:
+	// nos da grade junto da superficie, desenhados como pontos
+	std::vector<float> _surfaceCoord;
+	std::vector<float> _surfaceColor;
+
+	void UpdateSurface();
+	void CollideScalar(ParticleStore* store, float dissipative, int begin, int end) const;
+};
+
+#endif
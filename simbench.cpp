@@ -0,0 +1,296 @@
+// simbench.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+// Executavel sem janela: carrega uma cena, executa um numero fixo de passos
+// e mede o tempo total e o de cada fase de Simulation::Update (ver
+// Simulation::_timing).
+//
+// uso: simbench [opcoes] <cena> [passos] [threads] [tamanho]
+//   cena:    rain, fountain, cube, cloth, drape, bowl ou terrain
+//   passos:  numero de passos (padrao 1000)
+//   threads: threads do escalonador (padrao 1)
+//   tamanho: particulas da chuva ou do anel da fonte, numero de cubos ou
+//            resolucao do pano
+//   --trace: grava as zonas medidas em formato de eventos do Chrome
+//            (requer compilacao com PROFILER, -DSIMFIS_PROFILER=ON no CMake)
+//   --record: grava as trajetorias de todos os passos (ver trajectory.h)
+//   --integrator: euler (padrao), verlet, symplectic, leapfrog, rk4 ou
+//                 implicit
+//   --dt: passo de tempo do integrador
+//   --broadphase: grid (padrao), sap (ordenacao e varredura), tree
+//     (hierarquia de caixas) ou brute
+//   --sleep: poe para dormir as ilhas em repouso (ver islands.h)
+//   --reorder: reordena as particulas pela curva de Morton (ver mortonorder.h)
+//   --ccd: colisao continua das particulas rapidas (ver continuouscollision.h)
+//   --mesh: acrescenta a cena um obstaculo de malha de triangulos (.obj,
+//           .ply ou .bvh ja construido, ver meshcollider.h)
+//   --save-bvh: grava a hierarquia da malha de --mesh para cargas futuras
+//   --adaptive: passo adaptativo com a tolerancia dada (ver timestepper.h);
+//               cada "passo" passa a ser um quadro de 1/60 s entregue a
+//               Simulation::Advance; os tempos das fases incluem os passos
+//               de teste da estimativa de erro
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "profiler.h"
+#include "scene.h"
+#include "trajectory.h"
+#include "simulation.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// na ordem de Simulation::Phase
+static const char* s_phaseNames[Simulation::PHASES] =
+{
+	"springs",
+	"forces",
+	"integration",
+	"ccd",
+	"collisions",
+	"planes",
+	"reset",
+	"constraints",
+	"islands",
+	"emission"
+};
+
+static double s_pairs;
+static double s_fast;
+static int s_impacts;
+
+static double Seconds(Clock::time_point begin, Clock::time_point end)
+{
+	return std::chrono::duration<double>(end - begin).count();
+}
+
+// Executa um passo e acumula as estatisticas do passo; os tempos das fases
+// sao somados pela propria simulacao (Simulation::_timing)
+static void Step(Simulation* simulation)
+{
+	simulation->Update();
+	s_pairs += (double)(simulation->_pairs.size() / 2);
+	s_fast += simulation->_continuous._fastCount;
+	s_impacts += simulation->_continuous._impacts;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* trace = 0;
+	const char* record = 0;
+	const char* integrator = 0;
+	const char* broadphase = 0;
+	float timeStep = 0.0f;
+	float tolerance = 0.0f;
+	bool sleep = false;
+	bool reorder = false;
+	bool ccd = false;
+	const char* mesh = 0;
+	const char* saveBvh = 0;
+	const char* args[4] = { 0, 0, 0, 0 };
+	int count = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+			trace = argv[++i];
+		else if(strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+			record = argv[++i];
+		else if(strcmp(argv[i], "--integrator") == 0 && i + 1 < argc)
+			integrator = argv[++i];
+		else if(strcmp(argv[i], "--broadphase") == 0 && i + 1 < argc)
+			broadphase = argv[++i];
+		else if(strcmp(argv[i], "--dt") == 0 && i + 1 < argc)
+			timeStep = (float)atof(argv[++i]);
+		else if(strcmp(argv[i], "--adaptive") == 0 && i + 1 < argc)
+			tolerance = (float)atof(argv[++i]);
+		else if(strcmp(argv[i], "--sleep") == 0)
+			sleep = true;
+		else if(strcmp(argv[i], "--reorder") == 0)
+			reorder = true;
+		else if(strcmp(argv[i], "--ccd") == 0)
+			ccd = true;
+		else if(strcmp(argv[i], "--mesh") == 0 && i + 1 < argc)
+			mesh = argv[++i];
+		else if(strcmp(argv[i], "--save-bvh") == 0 && i + 1 < argc)
+			saveBvh = argv[++i];
+		else if(count < 4)
+			args[count++] = argv[i];
+	}
+
+	if(count < 1)
+	{
+		fprintf(stderr, "uso: %s [--trace arquivo] [--record arquivo] [--integrator nome] "
+			"[--broadphase nome] [--dt passo] [--adaptive tolerancia] [--sleep] [--reorder] [--ccd] [--mesh arquivo] [--save-bvh arquivo] "
+			"<rain|fountain|cube|cloth|drape|bowl|terrain> [passos] [threads] [tamanho]\n", argv[0]);
+		return 1;
+	}
+
+	const char* scene = args[0];
+	int steps = count > 1 ? atoi(args[1]) : 1000;
+	int threads = count > 2 ? atoi(args[2]) : 1;
+	int size = count > 3 ? atoi(args[3]) : 0;
+
+#ifndef PROFILER
+	if(trace != 0)
+		fprintf(stderr, "aviso: compilado sem PROFILER, o trace ficara vazio\n");
+#endif
+	if(trace != 0)
+		Profiler::Enable(true);
+
+	Simulation* simulation = new Simulation();
+	if(!Scene::Load(simulation, scene, size))
+	{
+		fprintf(stderr, "cena desconhecida: %s\n", scene);
+		return 1;
+	}
+	if(mesh != 0)
+	{
+		Clock::time_point start = Clock::now();
+		MeshCollider* collider = new MeshCollider();
+		if(!collider->Load(mesh))
+		{
+			fprintf(stderr, "nao foi possivel ler a malha %s\n", mesh);
+			return 1;
+		}
+		printf("mesh %s: %d triangles, %d nodes, loaded in %.3f ms\n",
+			mesh, collider->TriangleCount(), collider->NodeCount(), 1.0e3 * Seconds(start, Clock::now()));
+		if(saveBvh != 0 && !collider->Save(saveBvh))
+		{
+			fprintf(stderr, "erro ao gravar %s\n", saveBvh);
+			return 1;
+		}
+		simulation->AddMesh(collider);
+	}
+	if(integrator != 0)
+	{
+		Integrator* selected = Scene::CreateIntegrator(integrator);
+		if(selected == 0)
+		{
+			fprintf(stderr, "integrador desconhecido: %s\n", integrator);
+			return 1;
+		}
+		delete simulation->_integrator;
+		simulation->_integrator = selected;
+	}
+	if(broadphase != 0)
+	{
+		if(strcmp(broadphase, "brute") == 0)
+			simulation->_broadphase = Simulation::BRUTE_FORCE;
+		else if(strcmp(broadphase, "grid") == 0)
+			simulation->_broadphase = Simulation::GRID;
+		else if(strcmp(broadphase, "sap") == 0)
+			simulation->_broadphase = Simulation::SWEEP_AND_PRUNE;
+		else if(strcmp(broadphase, "tree") == 0)
+			simulation->_broadphase = Simulation::AABB_TREE;
+		else
+		{
+			fprintf(stderr, "fase larga desconhecida: %s\n", broadphase);
+			return 1;
+		}
+	}
+	if(timeStep > 0.0f)
+		simulation->_integrator->_fixedTimeStep = timeStep;
+	if(tolerance > 0.0f)
+	{
+		simulation->_stepper._adaptive = true;
+		simulation->_stepper._tolerance = tolerance;
+	}
+	simulation->_islands._enabled = sleep;
+	simulation->_morton._enabled = reorder;
+	simulation->_continuous._enabled = ccd;
+	simulation->_scheduler.Initialize(threads);
+	simulation->_timing = true;
+
+	TrajectoryRecorder recorder;
+	if(record != 0 && !recorder.Open(record))
+	{
+		fprintf(stderr, "nao foi possivel criar %s\n", record);
+		return 1;
+	}
+
+	// as cenas com emissor comecam vazias: a metrica por particula usa a
+	// media do numero de particulas ao fim de cada passo
+	int particles = simulation->_store._count;
+	double particleSteps = 0.0;
+	printf("scene %s: %d particles, %d springs, %d constraints, %d threads\n",
+		scene, particles, simulation->_springs._count, simulation->_constraints._count,
+		simulation->_scheduler._threadCount);
+
+	Clock::time_point begin = Clock::now();
+	for(int i = 0; i < steps; i++)
+	{
+		if(tolerance > 0.0f)
+			simulation->Advance(1.0f / 60.0f);
+		else
+			Step(simulation);
+		particleSteps += simulation->_store._count;
+		if(record != 0)
+			recorder.Record(&simulation->_store);
+	}
+	double total = Seconds(begin, Clock::now());
+
+	if(record != 0 && !recorder.Close())
+	{
+		fprintf(stderr, "erro ao gravar %s\n", record);
+		return 1;
+	}
+
+	double nsPerStep = steps > 0 ? 1.0e9 * total / steps : 0.0;
+	double meanParticles = steps > 0 ? particleSteps / steps : 0.0;
+	printf("%d steps in %.3f s\n", steps, total);
+	printf("particles: %d at start, %d at end, %.1f mean\n", particles, simulation->_store._count, meanParticles);
+	printf("%-18s %14.1f\n", "ns/step", nsPerStep);
+	printf("%-18s %14.3f\n", "ns/particle/step", meanParticles > 0.0 ? nsPerStep / meanParticles : 0.0);
+	if(simulation->_particleGenerator != 0)
+	{
+		printf("emission: %d emitted, %d live\n",
+			simulation->_particleGenerator->_generated, simulation->_particleGenerator->_live);
+	}
+	if(tolerance <= 0.0f)
+		printf("%-18s %14.1f\n", "pairs/step", steps > 0 ? s_pairs / steps : 0.0);
+	if(simulation->_broadphase == Simulation::SWEEP_AND_PRUNE)
+		printf("sap: axis %d, %d rebuilds, last %d swaps\n", simulation->_sweep._axis, simulation->_sweep._rebuilds, simulation->_sweep._swaps);
+	if(simulation->_broadphase == Simulation::AABB_TREE)
+		printf("tree: %d rebuilds, %d subtree rebuilds\n", simulation->_tree._rebuilds, simulation->_tree._subtreeRebuilds);
+	if(reorder)
+		printf("reorder: %d passes, last disorder %.3f\n", simulation->_morton._reorders, simulation->_morton._disorder);
+	if(ccd && tolerance <= 0.0f)
+		printf("ccd: %.1f fast particles/step, %d impacts\n", steps > 0 ? s_fast / steps : 0.0, s_impacts);
+	if(sleep)
+	{
+		printf("sleeping: %d of %d particles, %d islands\n",
+			simulation->_islands._sleepingCount, simulation->_store._count, simulation->_islands._islandCount);
+	}
+	if(tolerance > 0.0f)
+	{
+		const TimeStepper& stepper = simulation->_stepper;
+		printf("adaptive: %d accepted, %d rejected, last dt %g, last error %g\n",
+			stepper._steps, stepper._rejected, stepper._timeStep, stepper._error);
+	}
+
+	printf("\n%-18s %14s %8s\n", "phase", "ns/step", "%");
+	for(int i = 0; i < Simulation::PHASES; i++)
+	{
+		double phaseTime = simulation->_phaseTime[i];
+		double ns = steps > 0 ? 1.0e9 * phaseTime / steps : 0.0;
+		printf("%-18s %14.1f %7.1f%%\n", s_phaseNames[i], ns,
+			total > 0.0 ? 100.0 * phaseTime / total : 0.0);
+	}
+
+	if(trace != 0)
+	{
+		if(!Profiler::Export(trace))
+		{
+			fprintf(stderr, "nao foi possivel gravar %s\n", trace);
+			return 1;
+		}
+		printf("\ntrace written to %s\n", trace);
+	}
+
+	return 0;
+}
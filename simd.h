@@ -0,0 +1,45 @@
+// simd.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SIMD_H
+#define SIMD_H
+
+// Habilita os kernels SSE quando o compilador gera SSE2 (x64, /arch:SSE2
+// ou -msse2). Sem SSE2 os kernels usam apenas o caminho escalar.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#define SIMD_ALIGN(n) __declspec(align(n))
+#else
+#define SIMD_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
+#ifdef SIMD_SSE
+// Faixas de a onde mask e verdadeira e de b nas demais
+static inline __m128 SimdSelect(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Carrega 4 vetores de 3 floats consecutivos (x0 y0 z0 x1 y1 ...) em
+// estrutura de vetores
+static inline void SimdLoad3(const float* p, __m128& x, __m128& y, __m128& z)
+{
+	__m128 a = _mm_loadu_ps(p);			// x0 y0 z0 x1
+	__m128 b = _mm_loadu_ps(p + 4);		// y1 z1 x2 y2
+	__m128 c = _mm_loadu_ps(p + 8);		// z2 x3 y3 z3
+
+	x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+		_mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+		_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+#endif
+
+#endif
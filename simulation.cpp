@@ -4,19 +4,52 @@
 // PUC-Rio, Set 2009
 
 #include "graphics.h"
+#include "profiler.h"
 #include "simulation.h"
 
-Simulation::Simulation()
+// Soma a duracao do escopo ao tempo da fase quando a medicao esta ligada
+class PhaseTimer
 {
-	_currPlane = 0;
-	_currSpring = 0;
-	_currParticle = 0;
-	_currConstraint = 0;
-	_currForceGenerator = 0;
+public:
+	PhaseTimer(Simulation* simulation, Simulation::Phase phase)
+	{
+		_time = simulation->_timing ? &simulation->_phaseTime[phase] : 0;
+		_begin = _time != 0 ? Profiler::Now() : 0;
+	}
 
+	~PhaseTimer()
+	{
+		if(_time != 0)
+			*_time += 1.0e-9 * (double)(Profiler::Now() - _begin);
+	}
+
+private:
+	double* _time;
+	long long _begin;
+};
+
+Simulation::Simulation()
+{
 	_dissipative = 0.5f;
+	_chunkSize = 1024;
+	_broadphase = GRID;
 
+	_particleGenerator = 0;
 	_integrator = new Integrator();
+
+	_timing = false;
+	for(int i = 0; i < PHASES; i++)
+		_phaseTime[i] = 0.0;
+}
+
+void Simulation::Reserve(int particles, int springs, int constraints)
+{
+	if(particles > _store._capacity)
+		_store.Reserve(particles > 2 * _store._capacity ? particles : 2 * _store._capacity);
+	if(springs > _springs._capacity)
+		_springs.Reserve(springs > 2 * _springs._capacity ? springs : 2 * _springs._capacity);
+	if(constraints > _constraints._capacity)
+		_constraints.Reserve(constraints > 2 * _constraints._capacity ? constraints : 2 * _constraints._capacity);
 }
 
 void Simulation::AddCube(Cube* cube)
@@ -24,19 +57,24 @@ void Simulation::AddCube(Cube* cube)
 	float stiffness = 100.0f;
 	float damping = 0.5f;
 
+	// 35 molas ligando cada vertice aos demais
+	Reserve(_store._count + VERTICES, _springs._count + 35, _constraints._count);
+
 	// adiciona as particulas do cubo ao sistema
-    for(int i = _currParticle; i < _currParticle + 8; i++)
-	{
-		_particles[i] = &cube->_particles[i - _currParticle];
-	}
-	_currParticle += 8;
+	// as molas usam as posicoes; o objeto guarda os identificadores
+	int firstId;
+	int first = _store.AddRange(cube->_particles, VERTICES, &firstId);
+	cube->_store = &_store;
+	cube->_firstParticle = firstId;
+	// a partir daqui o estado das particulas fica apenas no store
+	cube->ReleaseParticles();
 	
 	// cria as molas do cubo
     for(int j = 0; j < 7; j++)
 	{
 		for(int k = j; k < 8; k++)
 		{
-			AddSpring(stiffness, damping, &cube->_particles[j], &cube->_particles[k]);	
+			AddSpring(stiffness, damping, first + j, first + k);	
 		}
 	}
 }
@@ -47,17 +85,22 @@ void Simulation::AddCloth(Cloth* cloth)
 	float damping = 0.5f;
 
 	// adiciona as particulas do pano ao sistema
-	int j = cloth->_dimU * cloth->_dimV;
-	for(int i = _currParticle; i < _currParticle + j; i++)
-	{
-		_particles[i] = &cloth->_particles[i - _currParticle];
-	}
-	_currParticle += j;
+	// as molas usam as posicoes; o objeto guarda os identificadores
+	int firstId;
+	int first = _store.AddRange(cloth->_particles, cloth->_dimU * cloth->_dimV, &firstId);
+	cloth->_store = &_store;
+	cloth->_firstParticle = firstId;
+	// a partir daqui o estado das particulas fica apenas no store
+	cloth->ReleaseParticles();
 
 	// cria as molas do pano
 	int nU = cloth->_dimU;
 	int nV = cloth->_dimV;
 
+	int springs = (nU-1) * (2 + 4*(nV-1)) + (nU-2) * (2 + 2*(nV-2));
+	int constraints = (nU-1) * (2 + 2*(nV-1));
+	Reserve(_store._count, _springs._count + springs, _constraints._count + constraints);
+
 	int lastRow = nU *(nV-1);
 
 	Vector3 v;
@@ -66,266 +109,482 @@ void Simulation::AddCloth(Cloth* cloth)
 	int index = 0;
 	for(int i = 0; i < nU-1; i++)
 	{
-		v = cloth->_particles[lastRow+i]._currPosition;
-		v -= cloth->_particles[lastRow+i+1]._currPosition;
+		v = _store._currPosition[first+lastRow+i];
+		v -= _store._currPosition[first+lastRow+i+1];
 		length = v.Length();
-		AddConstraint(length, &cloth->_particles[lastRow+i], &cloth->_particles[lastRow+i+1]);
-		AddSpring(stiffness, damping, &cloth->_particles[lastRow+i], &cloth->_particles[lastRow+i+1]);
+		AddConstraint(length, first+lastRow+i, first+lastRow+i+1);
+		AddSpring(stiffness, damping, first+lastRow+i, first+lastRow+i+1);
 		for(int j = 0; j < nV-1; j++)
 		{
-			v = cloth->_particles[index]._currPosition;
-			v -= cloth->_particles[index+1]._currPosition;
+			v = _store._currPosition[first+index];
+			v -= _store._currPosition[first+index+1];
 			length = v.Length();
-			AddConstraint(length, &cloth->_particles[index], &cloth->_particles[index+1]);
+			AddConstraint(length, first+index, first+index+1);
 
-			v = cloth->_particles[index]._currPosition;
-			v -= cloth->_particles[index+nV]._currPosition;
+			v = _store._currPosition[first+index];
+			v -= _store._currPosition[first+index+nV];
 			length = v.Length();
-			AddConstraint(length, &cloth->_particles[index], &cloth->_particles[index+nV]);
+			AddConstraint(length, first+index, first+index+nV);
 
-			AddSpring(stiffness, damping, &cloth->_particles[index], &cloth->_particles[index+1]);
-			AddSpring(stiffness, damping, &cloth->_particles[index], &cloth->_particles[index+nV]);
-			AddSpring(stiffness, damping, &cloth->_particles[index], &cloth->_particles[index+nV+1]);
-			AddSpring(stiffness, damping, &cloth->_particles[index+1], &cloth->_particles[index+nV]);
+			AddSpring(stiffness, damping, first+index, first+index+1);
+			AddSpring(stiffness, damping, first+index, first+index+nV);
+			AddSpring(stiffness, damping, first+index, first+index+nV+1);
+			AddSpring(stiffness, damping, first+index+1, first+index+nV);
 			index++;
 		}
-		v = cloth->_particles[index]._currPosition;
-		v -= cloth->_particles[index+nV]._currPosition;
+		v = _store._currPosition[first+index];
+		v -= _store._currPosition[first+index+nV];
 		length = v.Length();
-		AddConstraint(length, &cloth->_particles[index], &cloth->_particles[index+nV]);
-		AddSpring(stiffness, damping, &cloth->_particles[index], &cloth->_particles[index+nV]);
+		AddConstraint(length, first+index, first+index+nV);
+		AddSpring(stiffness, damping, first+index, first+index+nV);
 		index++;
 	}
 
 	index = 0;
 	for(int i = 0; i < nU-2; i++)
 	{
-		AddSpring(stiffness, damping, &cloth->_particles[lastRow+i],   &cloth->_particles[lastRow+i+2]);
+		AddSpring(stiffness, damping, first+lastRow+i,   first+lastRow+i+2);
 		for(int j = 0; j < nV-2; j++)
 		{
-			AddSpring(stiffness, damping, &cloth->_particles[index],   &cloth->_particles[index+2]);
-			AddSpring(stiffness, damping, &cloth->_particles[index],   &cloth->_particles[index+nV+nV]);
+			AddSpring(stiffness, damping, first+index,   first+index+2);
+			AddSpring(stiffness, damping, first+index,   first+index+nV+nV);
 			index++;
 		}
-		AddSpring(stiffness, damping, &cloth->_particles[index], &cloth->_particles[index+nV+nV]);
+		AddSpring(stiffness, damping, first+index, first+index+nV+nV);
 		index += 2;
 	}
 }
 
 void Simulation::AddPlane(Plane* plane)
 {
-	_planes[_currPlane] = plane;
-	_currPlane++;
+	_planes.push_back(plane);
+}
+
+void Simulation::AddCollider(SdfCollider* collider)
+{
+	_colliders.push_back(collider);
+}
+
+void Simulation::AddMesh(MeshCollider* mesh)
+{
+	_meshes.push_back(mesh);
+}
+
+int Simulation::AddParticle(Particle* particle)
+{
+	return _store.Add(*particle);
 }
 
-void Simulation::AddParticle(Particle* particle)
+bool Simulation::RemoveParticle(ParticleHandle handle)
 {
-	_particles[_currParticle] = particle;
-	_currParticle++;
+	int index = _store.Find(handle);
+	if(index < 0)
+		return false;
+
+	int moved = index == _store._count - 1 ? -1 : _store._count - 1;
+	_springs.RemoveParticle(index, moved);
+	_constraints.RemoveParticle(index, moved);
+	_islands.RemoveParticle(&_store, index, moved);
+	_store.Remove(index);
+
+	return true;
 }
 
 void Simulation::AddForceGenerator(ForceGenerator* forceGenerator)
 {
-	_forceGenerators[_currForceGenerator] = forceGenerator;
-	_currForceGenerator++;
+	_forceGenerators.push_back(forceGenerator);
 }
 
 void Simulation::AddParticleGenerator(ParticleGenerator* particleGenerator)
 {
-	// adiciona as particulas do gerador ao sistema
-	for(int i = _currParticle; i < _currParticle + particleGenerator->_max; i++)
-	{
-		_particles[i] = particleGenerator->_particles[i - _currParticle];
-	}
-	_currParticle += particleGenerator->_max;
+	_particleGenerator = particleGenerator;
+	particleGenerator->Start(this);
 }
 
-void Simulation::AddConstraint(float length, Particle* particleA, Particle* particleB)
+void Simulation::AddConstraint(float length, int particleA, int particleB)
 {
-	Constraint* constraint = new Constraint(length, particleA, particleB);
-	_constraints[_currConstraint] = constraint;
-	_currConstraint++;
+	_constraints.Add(length, particleA, particleB);
 }
 
-void Simulation::AddSpring(float stiffness, float damping, Particle* particleA, Particle* particleB)
+void Simulation::AddSpring(float stiffness, float damping, int particleA, int particleB)
 {
-	Spring* spring = new Spring(stiffness, damping, particleA, particleB);
-	_springs[_currSpring] = spring;
-	_currSpring++;
+	Vector3 direction = _store._currPosition[particleA];
+	direction -= _store._currPosition[particleB];
+
+	_springs.Add(stiffness, damping, particleA, particleB, direction.Length());
 }
 
 void Simulation::UpdateSprings()
 {
-	Particle p;
-	for(int i = 0; i < _currSpring; i++)
+	PROFILE_ZONE("Simulation::UpdateSprings", 0);
+
+	SpringTable& springs = _springs;
+	ParticleStore* store = &_store;
+
+	// forca de cada mola e depois a soma por particula; nenhuma das etapas
+	// escreve na mesma posicao a partir de blocos diferentes
+	springs.BuildIncidence(store->_count);
+	_scheduler.ParallelFor(0, springs._count, _chunkSize, [&](int begin, int end, int thread)
 	{
-		_springs[i]->ApplyForce(p);
-	}
+		PROFILE_ZONE("SpringTable::ComputeForces", thread);
+		springs.ComputeForces(store, begin, end);
+	});
+	_scheduler.ParallelFor(0, store->_count, _chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("SpringTable::GatherForces", thread);
+		springs.GatherForces(store, begin, end);
+	});
 }
 
 void Simulation::UpdateConstraints()
 {
+	PROFILE_ZONE("Simulation::UpdateConstraints", 0);
+
+	ConstraintTable& constraints = _constraints;
+	ParticleStore* store = &_store;
+
+	// cada cor e um lote sem particulas compartilhadas; as cores sao
+	// resolvidas em sequencia a cada iteracao
+	constraints.BuildBatches();
 	for(int i = 0; i < 10; i++)
 	{
-		for(int j = 0; j < _currConstraint; j++)
+		PROFILE_ZONE("ConstraintTable::Iteration", 0);
+
+		for(int c = 0; c < constraints._colorCount; c++)
 		{
-			_constraints[j]->SatisfyConstraint();
+			_scheduler.ParallelFor(constraints._batchStart[c], constraints._batchStart[c + 1], _chunkSize,
+				[&](int begin, int end, int thread)
+			{
+				PROFILE_ZONE("ConstraintTable::Satisfy", thread);
+				constraints.Satisfy(store, begin, end);
+			});
 		}
+		constraints.SatisfyUncolored(store);
 	}
 }
 
-void Simulation::UpdateParticles()
+void Simulation::ApplyForces()
 {
-	int i;
-	for(i = 0; i < _currParticle; i++)
+	PROFILE_ZONE("Simulation::ApplyForces", 0);
+
+	ParticleStore* store = &_store;
+	std::vector<ForceGenerator*>& generators = _forceGenerators;
+
+	_scheduler.ParallelFor(0, store->_count, _chunkSize, [&](int begin, int end, int thread)
 	{
-		if(_particles[i]->_particleType == Particle::ParticleType::ACTIVE)
+		PROFILE_ZONE("ForceGenerator::ApplyForce", thread);
+		for(int i = 0; i < (int)generators.size(); i++)
 		{
-			for(int j = 0; j < _currForceGenerator; j++)
-			{
-				_forceGenerators[j]->ApplyForce(_particles[i]);
-			}
+			generators[i]->ApplyForce(store, begin, end);
 		}
+	});
+}
+
+void Simulation::IntegrateParticles()
+{
+	PROFILE_ZONE("Simulation::IntegrateParticles", 0);
+
+	ParticleStore* store = &_store;
+	Integrator* integrator = _integrator;
+
+	// as forcas do primeiro estagio ja foram acumuladas; os demais estagios
+	// reavaliam molas e geradores no estado intermediario
+	integrator->Prepare(this);
+	for(int stage = 0; stage < integrator->Stages(); stage++)
+	{
+		if(stage > 0)
+			EvaluateForces();
+
+		_scheduler.ParallelFor(0, store->_count, _chunkSize, [&](int begin, int end, int thread)
+		{
+			PROFILE_ZONE("Integrator::Integrate", thread);
+			integrator->Integrate(store, stage, begin, end);
+		});
 	}
+}
+
+void Simulation::EvaluateForces()
+{
+	ResetForces();
+	UpdateSprings();
+	ApplyForces();
+}
+
+int Simulation::FindPairs()
+{
+	if(_broadphase == BRUTE_FORCE)
+		return _bruteForce.FindPairs(&_store, &_scheduler, _chunkSize, _pairs);
+	if(_broadphase == SWEEP_AND_PRUNE)
+		return _sweep.FindPairs(&_store, _pairs);
+	if(_broadphase == AABB_TREE)
+		return _tree.FindPairs(&_store, &_scheduler, _chunkSize, _pairs);
+	return _grid.FindPairs(&_store, &_scheduler, _chunkSize, _pairs);
+}
+
+void Simulation::UpdateCollisions()
+{
+	PROFILE_ZONE("Simulation::UpdateCollisions", 0);
+
+	ParticleStore* store = &_store;
+
+	// fase larga: cada par candidato aparece uma vez
+	int pairs = FindPairs();
 
-	for(i = 0; i < _currParticle; i++)
+	// fase estreita: o teste de contato de cada par e independente; a
+	// resposta altera as duas particulas e e aplicada em ordem
+	_contacts.resize(pairs);
+	int* pair = pairs > 0 ? &_pairs[0] : 0;
+	unsigned char* contact = pairs > 0 ? &_contacts[0] : 0;
+
+	_scheduler.ParallelFor(0, pairs, _chunkSize, [&](int begin, int end, int thread)
 	{
-		if(_particles[i]->_particleType == Particle::ParticleType::ACTIVE)
+		PROFILE_ZONE("Simulation::TestContacts", thread);
+		Vector3* position = store->_currPosition;
+		float* radius = store->_radius;
+
+		for(int i = begin; i < end; i++)
 		{
-			float mass = _particles[i]->_mass;
+			int a = pair[2*i];
+			int b = pair[2*i+1];
 
-			_acceleration.x = _particles[i]->_resultantForce.x / mass;
-			_acceleration.y = _particles[i]->_resultantForce.y / mass;
-			_acceleration.z = _particles[i]->_resultantForce.z / mass;
+			Vector3 distance = position[a];
+			distance -= position[b];
 
-			_integrator->Integrate(_acceleration, _particles[i]);
+			float h = radius[a] + radius[b];
+			contact[i] = distance.SqrLength() < h * h;
 		}
-	}
+	});
 
-	for(i = 0; i < _currParticle; i++)
 	{
-		for(int j = 0; j < _currParticle; j++)
+		PROFILE_ZONE("Simulation::CollideParticles", 0);
+		Particle::ParticleType* type = store->_particleType;
+		for(int i = 0; i < pairs; i++)
 		{
-			if(j != i)
+			if(!contact[i])
+				continue;
+
+			int a = pair[2*i];
+			int b = pair[2*i+1];
+
+			// o contato de uma particula que se move acorda a ilha da
+			// adormecida; contra particulas paradas a adormecida nao responde
+			if(type[a] == Particle::SLEEPING || type[b] == Particle::SLEEPING)
 			{
-				Vector3 distance;
-				distance.x = _particles[i]->_currPosition.x - _particles[j]->_currPosition.x;
-				distance.y = _particles[i]->_currPosition.y - _particles[j]->_currPosition.y;
-				distance.z = _particles[i]->_currPosition.z - _particles[j]->_currPosition.z;
-
-				float h = _particles[i]->_radius + _particles[j]->_radius;
-
-				if(distance.Length() < h)
-				{
-						float w = h - distance.Length();
-						distance.Normalize();
-						distance *= w / 2.0f;
-						_particles[i]->_currPosition += distance;
-						_particles[j]->_currPosition -= distance;
-
-						Vector3 ta, tb;
-						distance.Normalize();
-						ta = tb = distance;
-
-						ta *= Dot(_particles[i]->_currVelocity, distance);
-						tb *= Dot(_particles[j]->_currVelocity, distance);
-
-						ta *= 2.0f;
-						tb *= 2.0f;
-						
-						_particles[i]->_currVelocity -= ta;
-						_particles[j]->_currVelocity -= tb;
-
-						_particles[i]->_currVelocity *= _dissipative;
-						_particles[j]->_currVelocity *= _dissipative;
-				}
+				int sleeping = type[a] == Particle::SLEEPING ? a : b;
+				int other = sleeping == a ? b : a;
+				if(type[other] != Particle::ACTIVE || _islands.Resting(other))
+					continue;
+				_islands.Wake(store, sleeping);
 			}
+			CollideParticles(a, b);
 		}
 	}
+}
 
-	for(i = 0; i < _currParticle; i++)
-	{
-		for(int j = 0; j < _currPlane; j++)
-		{
-			Vector3 planeNormal = _planes[j]->_normal;
-			Vector3 planePosition = _planes[j]->_position;
-			planeNormal.Normalize();
+void Simulation::UpdateContinuousCollisions()
+{
+	PROFILE_ZONE("Simulation::UpdateContinuousCollisions", 0);
 
-			float d = -(planePosition.x * planeNormal.x +
-				planePosition.y * planeNormal.y +
-				planePosition.z * planeNormal.z);
+	_continuous.Collide(this);
+}
 
-			float distance = _particles[i]->_currPosition.x * planeNormal.x +
-				_particles[i]->_currPosition.y * planeNormal.y +
-				_particles[i]->_currPosition.z * planeNormal.z + d;
+void Simulation::UpdatePlaneCollisions()
+{
+	PROFILE_ZONE("Simulation::UpdatePlaneCollisions", 0);
 
-			distance -= _particles[i]->_radius;
+	ParticleStore* store = &_store;
+	std::vector<Plane*>& planes = _planes;
+	std::vector<SdfCollider*>& colliders = _colliders;
+	std::vector<MeshCollider*>& meshes = _meshes;
+	float dissipative = _dissipative;
 
-			if(distance < 0.0f)
-			{
-				planeNormal *= -distance;
-				_particles[i]->_currPosition += planeNormal;
+	_scheduler.ParallelFor(0, store->_count, _chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("Plane::Collide", thread);
+		Plane::Collide(planes, store, dissipative, begin, end);
+		for(int j = 0; j < (int)colliders.size(); j++)
+		{
+			colliders[j]->Collide(store, dissipative, begin, end);
+		}
+		for(int j = 0; j < (int)meshes.size(); j++)
+		{
+			meshes[j]->Collide(store, dissipative, begin, end);
+		}
+	});
+}
 
-				Vector3 t;
-				planeNormal.Normalize();
-				t = planeNormal;
+void Simulation::ResetForces()
+{
+	PROFILE_ZONE("Simulation::ResetForces", 0);
 
-				t *= Dot(_particles[i]->_currVelocity, planeNormal);
+	ParticleStore* store = &_store;
 
-				t *= 2.0f;
-				
-				_particles[i]->_currVelocity -= t;
+	_scheduler.ParallelFor(0, store->_count, _chunkSize, [&](int begin, int end, int thread)
+	{
+		PROFILE_ZONE("ParticleStore::ResetForces", thread);
+		store->ResetForces(begin, end);
+	});
+}
 
-				_particles[i]->_currVelocity *= _dissipative;
-			}
-		}
+void Simulation::UpdateParticles()
+{
+	{
+		PhaseTimer timer(this, PHASE_FORCES);
+		ApplyForces();
+	}
+	{
+		PhaseTimer timer(this, PHASE_CONTINUOUS);
+		_continuous.Begin(&_store);
+	}
+	{
+		PhaseTimer timer(this, PHASE_INTEGRATION);
+		IntegrateParticles();
+	}
+	{
+		PhaseTimer timer(this, PHASE_CONTINUOUS);
+		UpdateContinuousCollisions();
+	}
+	{
+		PhaseTimer timer(this, PHASE_COLLISIONS);
+		UpdateCollisions();
+	}
+	{
+		PhaseTimer timer(this, PHASE_PLANES);
+		UpdatePlaneCollisions();
+	}
+	{
+		PhaseTimer timer(this, PHASE_RESET);
+		ResetForces();
 	}
+}
+
+void Simulation::CollideParticles(int particleA, int particleB)
+{
+	Vector3& positionA = _store._currPosition[particleA];
+	Vector3& positionB = _store._currPosition[particleB];
+	Vector3& velocityA = _store._currVelocity[particleA];
+	Vector3& velocityB = _store._currVelocity[particleB];
+
+	Vector3 distance;
+	distance.x = positionA.x - positionB.x;
+	distance.y = positionA.y - positionB.y;
+	distance.z = positionA.z - positionB.z;
 
-	for(i = 0; i < _currParticle; i++)
+	float h = _store._radius[particleA] + _store._radius[particleB];
+
+	if(distance.Length() < h)
 	{
-		if(_particles[i]->_particleType == Particle::ParticleType::ACTIVE)
-            _particles[i]->ResetForces();
+		float w = h - distance.Length();
+		distance.Normalize();
+		distance *= w / 2.0f;
+		positionA += distance;
+		positionB -= distance;
+
+		Vector3 ta, tb;
+		distance.Normalize();
+		ta = tb = distance;
+
+		ta *= Dot(velocityA, distance);
+		tb *= Dot(velocityB, distance);
+
+		ta *= 2.0f;
+		tb *= 2.0f;
+
+		velocityA -= ta;
+		velocityB -= tb;
+
+		velocityA *= _dissipative;
+		velocityB *= _dissipative;
 	}
 }
 
 void Simulation::UpdateParticleGenerator()
 {
-	_particleGenerator->Update();
+	if(_particleGenerator != 0)
+		_particleGenerator->Update(this, _integrator->_fixedTimeStep);
+}
+
+void Simulation::UpdateLocality()
+{
+	_morton.Update(this);
+}
+
+void Simulation::UpdateIslands()
+{
+	if(_islands._enabled)
+		_islands.Update(this);
 }
 
 void Simulation::Update()
 {
-	UpdateSprings();
+	PROFILE_ZONE("Simulation::Update", 0);
+
+	// a reordenacao e contada com as molas, que ela torna contiguas
+	{
+		PhaseTimer timer(this, PHASE_SPRINGS);
+		UpdateLocality();
+		UpdateSprings();
+	}
 	UpdateParticles();
-	UpdateConstraints();
+	{
+		PhaseTimer timer(this, PHASE_CONSTRAINTS);
+		UpdateConstraints();
+	}
+	{
+		PhaseTimer timer(this, PHASE_ISLANDS);
+		UpdateIslands();
+	}
+	{
+		PhaseTimer timer(this, PHASE_EMISSION);
+		UpdateParticleGenerator();
+	}
+}
+
+int Simulation::Advance(float elapsed)
+{
+	return _stepper.Advance(this, elapsed);
 }
 
 void Simulation::DrawPlanes()
 {
-	for(int i = 0; i < _currPlane; i++)
+	PROFILE_ZONE("Simulation::DrawPlanes", 0);
+
+	for(int i = 0; i < (int)_planes.size(); i++)
 	{
 		_planes[i]->Draw();
 	}
+	for(int i = 0; i < (int)_colliders.size(); i++)
+	{
+		_colliders[i]->Draw();
+	}
+	for(int i = 0; i < (int)_meshes.size(); i++)
+	{
+		_meshes[i]->Draw();
+	}
 }
 
 void Simulation::DrawSprings()
 {
-	for(int i = 0; i < _currSpring; i++)
-	{
-		_springs[i]->Draw();
-	}
+	PROFILE_ZONE("Simulation::DrawSprings", 0);
+
+	_springs.Draw(&_store);
 }
 
 void Simulation::DrawParticles()
 {
-	for(int i = 0; i < _currParticle; i++)
+	PROFILE_ZONE("Simulation::DrawParticles", 0);
+
+	for(int i = 0; i < _store._count; i++)
 	{
-		_particles[i]->DrawSphere();
+		Graphics::DrawSphereParticles(
+			1, _store._radius[i], &_store._currPosition[i].x, &_store._color[3*i]);
 	}
 }
 
 void Simulation::Draw()
 {
+	PROFILE_ZONE("Simulation::Draw", 0);
+
 	DrawPlanes();
 	DrawSprings();
 	DrawParticles();
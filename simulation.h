@@ -6,58 +6,145 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
+#include <vector>
+
 #include "cube.h"
+#include "aabbtree.h"
+#include "grid.h"
 #include "cloth.h"
+#include "bruteforce.h"
 #include "euler.h"
 #include "plane.h"
-#include "spring.h"
 #include "verlet.h"
+#include "leapfrog.h"
 #include "particle.h"
+#include "islands.h"
 #include "integrator.h"
-#include "constraint.h"
+#include "meshcollider.h"
+#include "mortonorder.h"
+#include "continuouscollision.h"
+#include "impliciteuler.h"
+#include "rungekutta4.h"
+#include "scheduler.h"
+#include "timestepper.h"
+#include "particlestore.h"
+#include "sdfcollider.h"
+#include "springtable.h"
+#include "constrainttable.h"
 #include "forcegenerator.h"
 #include "particlegenerator.h"
+#include "symplecticeuler.h"
+#include "sweepandprune.h"
 
 class Simulation
 {
 public:
+	// fase larga da colisao entre particulas
+	enum BroadphaseType
+	{
+		BRUTE_FORCE,
+		GRID,
+		SWEEP_AND_PRUNE,
+		AABB_TREE
+	};
+
+	// fases de Update, para a medicao por fase
+	enum Phase
+	{
+		PHASE_SPRINGS,
+		PHASE_FORCES,
+		PHASE_INTEGRATION,
+		PHASE_CONTINUOUS,
+		PHASE_COLLISIONS,
+		PHASE_PLANES,
+		PHASE_RESET,
+		PHASE_CONSTRAINTS,
+		PHASE_ISLANDS,
+		PHASE_EMISSION,
+		PHASES
+	};
+
 	Simulation();
 	
-	int _currPlane;
-	int _currSpring;
-	int _currParticle;
-	int _currConstraint;
-	int _currForceGenerator;
-
 	float _dissipative;
-	
-	Vector3 _acceleration;
+	int _chunkSize;
 
-	Plane* _planes[10];
-	Spring* _springs[1024];
-	Particle* _particles[1024];
-	Constraint* _constraints[1024];
-	ForceGenerator* _forceGenerators[5];
+	std::vector<Plane*> _planes;
+	std::vector<SdfCollider*> _colliders;
+	std::vector<MeshCollider*> _meshes;
+	SpringTable _springs;
+	ConstraintTable _constraints;
+	std::vector<ForceGenerator*> _forceGenerators;
 	ParticleGenerator* _particleGenerator;
 
+	ParticleStore _store;
+
 	Integrator* _integrator;
 
+	BroadphaseType _broadphase;
+	BruteForce _bruteForce;
+	Grid _grid;
+	SweepAndPrune _sweep;
+	AabbTree _tree;
+	// pares candidatos do passo (2 indices por par) e resultado do teste de
+	// contato de cada par
+	std::vector<int> _pairs;
+	std::vector<unsigned char> _contacts;
+
+	Scheduler _scheduler;
+	TimeStepper _stepper;
+	IslandManager _islands;
+	MortonOrder _morton;
+	ContinuousCollision _continuous;
+
+	// com _timing, Update soma em _phaseTime o tempo (em segundos) de cada
+	// fase; independe de PROFILER
+	bool _timing;
+	double _phaseTime[PHASES];
+
+	// Executa um passo com o passo de tempo do integrador
 	void Update();
+	// Avanca por elapsed segundos de tempo real em passos do _stepper
+	int Advance(float elapsed);
 	void Draw();
 
+	void Reserve(int particles, int springs, int constraints);
+
 	void AddCube(Cube* cube);
 	void AddCloth(Cloth* cloth);
 	void AddPlane(Plane* plane);
-	void AddParticle(Particle* particle);
+	void AddCollider(SdfCollider* collider);
+	void AddMesh(MeshCollider* mesh);
+	int AddParticle(Particle* particle);
+	// Remove a particula e as molas e restricoes ligadas a ela; retorna false
+	// se o handle ja nao e valido. A ultima particula passa a ocupar a
+	// posicao liberada.
+	bool RemoveParticle(ParticleHandle handle);
 	void AddForceGenerator(ForceGenerator* forceGenerator);
 	void AddParticleGenerator(ParticleGenerator* particleGenerator);
-	void AddConstraint(float length, Particle* particleA, Particle* particleB);
-	void AddSpring(float stiffness, float damping, Particle* particleA, Particle* particleB);
+	void AddConstraint(float length, int particleA, int particleB);
+	void AddSpring(float stiffness, float damping, int particleA, int particleB);
 
 	void UpdateSprings();
 	void UpdateParticles();
 	void UpdateConstraints();
 	void UpdateParticleGenerator();
+	void UpdateIslands();
+	void UpdateLocality();
+
+	void ApplyForces();
+	void EvaluateForces();
+	void IntegrateParticles();
+	// Preenche _pairs com a fase larga escolhida; retorna o numero de pares
+	int FindPairs();
+	// Colisao continua das particulas rapidas, antes dos testes discretos
+	void UpdateContinuousCollisions();
+	void UpdateCollisions();
+	// Colisao com a geometria estatica: planos e obstaculos SDF
+	void UpdatePlaneCollisions();
+	void ResetForces();
+
+	void CollideParticles(int particleA, int particleB);
 
 	void DrawPlanes();
 	void DrawSprings();
@@ -0,0 +1,324 @@
+// springtable.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <algorithm>
+
+#include "graphics.h"
+
+#include "simd.h"
+#include "aligned.h"
+#include "particlestore.h"
+#include "springtable.h"
+
+SpringTable::SpringTable()
+{
+	_count = 0;
+	_capacity = 0;
+
+	_particleA = 0;
+	_particleB = 0;
+	_restLength = 0;
+	_stiffness = 0;
+	_damping = 0;
+	_forceX = 0;
+	_forceY = 0;
+	_forceZ = 0;
+
+	_version = 0;
+	_incidenceValid = false;
+}
+
+SpringTable::~SpringTable()
+{
+	AlignedFree(_particleA);
+	AlignedFree(_particleB);
+	AlignedFree(_restLength);
+	AlignedFree(_stiffness);
+	AlignedFree(_damping);
+	AlignedFree(_forceX);
+	AlignedFree(_forceY);
+	AlignedFree(_forceZ);
+}
+
+void SpringTable::Reserve(int capacity)
+{
+	if(capacity <= _capacity)
+		return;
+
+	AlignedResize(_particleA, _count, capacity);
+	AlignedResize(_particleB, _count, capacity);
+	AlignedResize(_restLength, _count, capacity);
+	AlignedResize(_stiffness, _count, capacity);
+	AlignedResize(_damping, _count, capacity);
+	AlignedResize(_forceX, _count, capacity);
+	AlignedResize(_forceY, _count, capacity);
+	AlignedResize(_forceZ, _count, capacity);
+
+	_capacity = capacity;
+}
+
+void SpringTable::Resize(int count)
+{
+	Reserve(count);
+	_count = count;
+	_version++;
+	_incidenceValid = false;
+}
+
+int SpringTable::Add(float stiffness, float damping, int particleA, int particleB, float restLength)
+{
+	if(_count == _capacity)
+		Reserve(_capacity < 64 ? 64 : 2 * _capacity);
+
+	int i = _count;
+	_particleA[i] = particleA;
+	_particleB[i] = particleB;
+	_restLength[i] = restLength;
+	_stiffness[i] = stiffness;
+	_damping[i] = damping;
+	_count++;
+
+	_version++;
+	_incidenceValid = false;
+
+	return i;
+}
+
+void SpringTable::Remap(const int* newIndex)
+{
+	std::vector<unsigned long long> keys(_count);
+	for(int i = 0; i < _count; i++)
+	{
+		_particleA[i] = newIndex[_particleA[i]];
+		_particleB[i] = newIndex[_particleB[i]];
+		unsigned int first = _particleA[i] < _particleB[i] ? _particleA[i] : _particleB[i];
+		keys[i] = ((unsigned long long)first << 32) | (unsigned int)i;
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<int> order(_count);
+	for(int i = 0; i < _count; i++)
+		order[i] = (int)(keys[i] & 0xffffffffu);
+
+	std::vector<int> copyA(_particleA, _particleA + _count);
+	std::vector<int> copyB(_particleB, _particleB + _count);
+	std::vector<float> copyRest(_restLength, _restLength + _count);
+	std::vector<float> copyStiffness(_stiffness, _stiffness + _count);
+	std::vector<float> copyDamping(_damping, _damping + _count);
+	for(int i = 0; i < _count; i++)
+	{
+		int k = order[i];
+		_particleA[i] = copyA[k];
+		_particleB[i] = copyB[k];
+		_restLength[i] = copyRest[k];
+		_stiffness[i] = copyStiffness[k];
+		_damping[i] = copyDamping[k];
+	}
+
+	_version++;
+	_incidenceValid = false;
+}
+
+void SpringTable::RemoveParticle(int particle, int moved)
+{
+	int count = 0;
+	for(int i = 0; i < _count; i++)
+	{
+		int a = _particleA[i];
+		int b = _particleB[i];
+		if(a == particle || b == particle)
+			continue;
+
+		_particleA[count] = a == moved ? particle : a;
+		_particleB[count] = b == moved ? particle : b;
+		_restLength[count] = _restLength[i];
+		_stiffness[count] = _stiffness[i];
+		_damping[count] = _damping[i];
+		count++;
+	}
+	_count = count;
+
+	_version++;
+	_incidenceValid = false;
+}
+
+void SpringTable::BuildIncidence(int particleCount)
+{
+	if(_incidenceValid && (int)_incidentStart.size() == particleCount + 1)
+		return;
+
+	_incidentStart.assign(particleCount + 1, 0);
+	_incident.resize(2 * _count);
+
+	for(int i = 0; i < _count; i++)
+	{
+		_incidentStart[_particleA[i] + 1]++;
+		_incidentStart[_particleB[i] + 1]++;
+	}
+	for(int p = 0; p < particleCount; p++)
+	{
+		_incidentStart[p + 1] += _incidentStart[p];
+	}
+
+	std::vector<int> next(_incidentStart.begin(), _incidentStart.end() - 1);
+	for(int i = 0; i < _count; i++)
+	{
+		_incident[next[_particleA[i]]++] = i;
+		_incident[next[_particleB[i]]++] = ~i;
+	}
+
+	_incidenceValid = true;
+}
+
+void SpringTable::ComputeForcesScalar(ParticleStore* store, int begin, int end)
+{
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+
+	for(int i = begin; i < end; i++)
+	{
+		int a = _particleA[i];
+		int b = _particleB[i];
+
+		Vector3 direction = position[a];
+		direction -= position[b];
+
+		float length = direction.Length();
+		if(length == 0.0f)
+		{
+			_forceX[i] = _forceY[i] = _forceZ[i] = 0.0f;
+			continue;
+		}
+		direction *= 1.0f / length;
+
+		Vector3 relativeVelocity = velocity[a];
+		relativeVelocity -= velocity[b];
+
+		// termo elastico e amortecimento ao longo da direcao da mola
+		float magnitude = -_stiffness[i] * (length - _restLength[i]) -
+			_damping[i] * Dot(relativeVelocity, direction);
+		_forceX[i] = direction.x * magnitude;
+		_forceY[i] = direction.y * magnitude;
+		_forceZ[i] = direction.z * magnitude;
+	}
+}
+
+void SpringTable::ComputeForces(ParticleStore* store, int begin, int end)
+{
+	int i = begin;
+
+#ifdef SIMD_SSE
+	Vector3* position = store->_currPosition;
+	Vector3* velocity = store->_currVelocity;
+
+	SIMD_ALIGN(16) float dx[4], dy[4], dz[4];
+	SIMD_ALIGN(16) float vx[4], vy[4], vz[4];
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	// o inicio dos lotes fica alinhado a 4 molas
+	for(; (i & 3) != 0 && i < end; i++)
+	{
+		ComputeForcesScalar(store, i, i + 1);
+	}
+
+	for(; i + 4 <= end; i += 4)
+	{
+		// coleta as diferencas de posicao e velocidade de 4 molas
+		for(int k = 0; k < 4; k++)
+		{
+			const Vector3& pa = position[_particleA[i+k]];
+			const Vector3& pb = position[_particleB[i+k]];
+			const Vector3& va = velocity[_particleA[i+k]];
+			const Vector3& vb = velocity[_particleB[i+k]];
+			dx[k] = pa.x - pb.x;
+			dy[k] = pa.y - pb.y;
+			dz[k] = pa.z - pb.z;
+			vx[k] = va.x - vb.x;
+			vy[k] = va.y - vb.y;
+			vz[k] = va.z - vb.z;
+		}
+
+		__m128 x = _mm_load_ps(dx);
+		__m128 y = _mm_load_ps(dy);
+		__m128 z = _mm_load_ps(dz);
+
+		__m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 valid = _mm_cmpneq_ps(length2, zero);
+		__m128 length = _mm_sqrt_ps(length2);
+		// molas de comprimento nulo nao geram forca
+		__m128 inverse = _mm_and_ps(valid, _mm_div_ps(one, _mm_or_ps(length, _mm_andnot_ps(valid, one))));
+
+		x = _mm_mul_ps(x, inverse);
+		y = _mm_mul_ps(y, inverse);
+		z = _mm_mul_ps(z, inverse);
+
+		__m128 relative = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_load_ps(vx), x),
+			_mm_mul_ps(_mm_load_ps(vy), y)),
+			_mm_mul_ps(_mm_load_ps(vz), z));
+
+		__m128 stretch = _mm_sub_ps(length, _mm_load_ps(&_restLength[i]));
+		__m128 magnitude = _mm_sub_ps(
+			_mm_mul_ps(_mm_xor_ps(_mm_load_ps(&_stiffness[i]), _mm_set1_ps(-0.0f)), stretch),
+			_mm_mul_ps(_mm_load_ps(&_damping[i]), relative));
+
+		_mm_store_ps(&_forceX[i], _mm_mul_ps(x, magnitude));
+		_mm_store_ps(&_forceY[i], _mm_mul_ps(y, magnitude));
+		_mm_store_ps(&_forceZ[i], _mm_mul_ps(z, magnitude));
+	}
+#endif
+
+	ComputeForcesScalar(store, i, end);
+}
+
+void SpringTable::GatherForces(ParticleStore* store, int begin, int end)
+{
+	Vector3* force = store->_resultantForce;
+
+	for(int p = begin; p < end; p++)
+	{
+		for(int k = _incidentStart[p]; k < _incidentStart[p + 1]; k++)
+		{
+			int s = _incident[k];
+			if(s >= 0)
+			{
+				force[p].x += _forceX[s];
+				force[p].y += _forceY[s];
+				force[p].z += _forceZ[s];
+			}
+			else
+			{
+				s = ~s;
+				force[p].x -= _forceX[s];
+				force[p].y -= _forceY[s];
+				force[p].z -= _forceZ[s];
+			}
+		}
+	}
+}
+
+void SpringTable::ApplyForces(ParticleStore* store)
+{
+	BuildIncidence(store->_count);
+	ComputeForces(store, 0, _count);
+	GatherForces(store, 0, store->_count);
+}
+
+void SpringTable::Draw(ParticleStore* store)
+{
+	for(int i = 0; i < _count; i++)
+	{
+		Vector3& positionA = store->_currPosition[_particleA[i]];
+		Vector3& positionB = store->_currPosition[_particleB[i]];
+
+		Vector3 direction = positionA;
+		direction -= positionB;
+
+		Graphics::DrawSpring(
+			direction.Length(), _restLength[i], &positionA.x, &positionB.x);
+	}
+}
@@ -0,0 +1,72 @@
+// springtable.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SPRINGTABLE_H
+#define SPRINGTABLE_H
+
+#include <vector>
+
+class ParticleStore;
+
+// Tabela plana de molas em estrutura de vetores. Cada mola e descrita pelos
+// indices das duas particulas, comprimento de repouso, rigidez e
+// amortecimento. A forca de cada mola e calculada em lotes de 4 com SSE e
+// guardada por mola; em seguida cada particula soma as forcas das molas
+// incidentes, em ordem crescente de mola. As duas etapas podem ser
+// divididas entre threads sem conflito de escrita.
+class SpringTable
+{
+public:
+	SpringTable();
+	~SpringTable();
+
+	int _count;
+	int _capacity;
+	// incrementado sempre que as ligacoes mudam (Add, Resize, Remap,
+	// RemoveParticle)
+	int _version;
+
+	int* _particleA;
+	int* _particleB;
+	float* _restLength;
+	float* _stiffness;
+	float* _damping;
+	float* _forceX;
+	float* _forceY;
+	float* _forceZ;
+
+	// molas incidentes em cada particula (s para o extremo A, ~s para o B)
+	std::vector<int> _incidentStart;
+	std::vector<int> _incident;
+
+	void Reserve(int capacity);
+	// Ajusta o numero de molas; o conteudo das novas fica indefinido
+	void Resize(int count);
+	int Add(float stiffness, float damping, int particleA, int particleB, float restLength);
+	// Troca o indice de cada extremo p por newIndex[p] e reordena as molas
+	// pelo menor extremo, para que as molas de particulas vizinhas na
+	// memoria tambem fiquem proximas
+	void Remap(const int* newIndex);
+	// Acompanha ParticleStore::Remove: descarta as molas da particula
+	// removida e troca o indice moved (a particula movida, se >= 0) por
+	// particle, mantendo a ordem das demais molas
+	void RemoveParticle(int particle, int moved);
+
+	void ApplyForces(ParticleStore* store);
+	void ComputeForces(ParticleStore* store, int begin, int end);
+	void GatherForces(ParticleStore* store, int begin, int end);
+	void BuildIncidence(int particleCount);
+	void Draw(ParticleStore* store);
+
+private:
+	bool _incidenceValid;
+
+	void ComputeForcesScalar(ParticleStore* store, int begin, int end);
+
+	SpringTable(const SpringTable&);
+	SpringTable& operator= (const SpringTable&);
+};
+
+#endif
@@ -0,0 +1,224 @@
+// sweepandprune.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <algorithm>
+
+#include "profiler.h"
+#include "particlestore.h"
+#include "sweepandprune.h"
+
+SweepAndPrune::SweepAndPrune()
+{
+	_axis = 0;
+	_swaps = 0;
+	_rebuilds = 0;
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+// ordem total dos extremos: valor e, no empate, codigo
+static inline bool Before(float valueA, int codeA, float valueB, int codeB)
+{
+	return valueA < valueB || (valueA == valueB && codeA < codeB);
+}
+
+void SweepAndPrune::Rebuild(ParticleStore* store)
+{
+	int count = store->_count;
+	const Vector3* position = store->_currPosition;
+
+	// eixo de maior variancia dos centros
+	double sum[3] = { 0.0, 0.0, 0.0 };
+	double sum2[3] = { 0.0, 0.0, 0.0 };
+	for(int i = 0; i < count; i++)
+	{
+		const float* p = &position[i].x;
+		for(int a = 0; a < 3; a++)
+		{
+			sum[a] += p[a];
+			sum2[a] += (double)p[a] * p[a];
+		}
+	}
+	_axis = 0;
+	double best = -1.0;
+	for(int a = 0; a < 3; a++)
+	{
+		double variance = sum2[a] - sum[a] * sum[a] / (count > 0 ? count : 1);
+		if(variance > best)
+		{
+			best = variance;
+			_axis = a;
+		}
+	}
+
+	std::vector<std::pair<float, int> > endpoints(2 * count);
+	for(int i = 0; i < count; i++)
+	{
+		float center = (&position[i].x)[_axis];
+		int id = store->_id[i];
+		endpoints[2*i] = std::make_pair(center - store->_radius[i], id << 1);
+		endpoints[2*i+1] = std::make_pair(center + store->_radius[i], (id << 1) | 1);
+	}
+	std::sort(endpoints.begin(), endpoints.end());
+
+	_value.resize(2 * count);
+	_code.resize(2 * count);
+	for(int k = 0; k < 2 * count; k++)
+	{
+		_value[k] = endpoints[k].first;
+		_code[k] = endpoints[k].second;
+	}
+
+	_tracked.assign(_tracked.size(), 0);
+	for(int i = 0; i < count; i++)
+		_tracked[store->_id[i]] = 1;
+
+	_rebuilds++;
+}
+
+void SweepAndPrune::Update(ParticleStore* store)
+{
+	const Vector3* position = store->_currPosition;
+	const float* radius = store->_radius;
+	int ids = (int)store->_slot.size();
+
+	// descarta os extremos de particulas removidas e atualiza os demais
+	int kept = 0;
+	for(int k = 0; k < (int)_code.size(); k++)
+	{
+		int code = _code[k];
+		int id = code >> 1;
+		int slot = id < ids ? store->_slot[id] : -1;
+		if(slot < 0)
+		{
+			if(id < ids)
+				_tracked[id] = 0;
+			continue;
+		}
+
+		float center = (&position[slot].x)[_axis];
+		_value[kept] = (code & 1) ? center + radius[slot] : center - radius[slot];
+		_code[kept] = code;
+		kept++;
+	}
+	_value.resize(kept);
+	_code.resize(kept);
+
+	// particulas novas entram no fim e sao posicionadas pela ordenacao
+	for(int i = 0; i < store->_count; i++)
+	{
+		int id = store->_id[i];
+		if(_tracked[id])
+			continue;
+
+		float center = (&position[i].x)[_axis];
+		_value.push_back(center - radius[i]);
+		_code.push_back(id << 1);
+		_value.push_back(center + radius[i]);
+		_code.push_back((id << 1) | 1);
+		_tracked[id] = 1;
+	}
+
+	Sort();
+}
+
+void SweepAndPrune::Sort()
+{
+	// ordenacao por insercao: linear quando a ordem muda pouco
+	_swaps = 0;
+	int n = (int)_code.size();
+	for(int k = 1; k < n; k++)
+	{
+		float value = _value[k];
+		int code = _code[k];
+		int j = k - 1;
+		while(j >= 0 && Before(value, code, _value[j], _code[j]))
+		{
+			_value[j + 1] = _value[j];
+			_code[j + 1] = _code[j];
+			j--;
+			_swaps++;
+		}
+		_value[j + 1] = value;
+		_code[j + 1] = code;
+	}
+}
+
+int SweepAndPrune::FindPairs(ParticleStore* store, std::vector<int>& pairs)
+{
+	PROFILE_ZONE("SweepAndPrune::FindPairs", 0);
+
+	int count = store->_count;
+	pairs.clear();
+
+	int ids = (int)store->_slot.size();
+	if((int)_tracked.size() < ids)
+		_tracked.resize(ids, 0);
+	_activeIndex.assign(ids, -1);
+
+	// muitas particulas novas: ordenacao completa
+	int fresh = 0;
+	for(int i = 0; i < count; i++)
+	{
+		if(!_tracked[store->_id[i]])
+			fresh++;
+	}
+	_swaps = 0;
+	if(_code.empty() || 2 * fresh > count)
+		Rebuild(store);
+	else
+		Update(store);
+
+	const Vector3* position = store->_currPosition;
+	const float* radius = store->_radius;
+	const Particle::ParticleType* type = store->_particleType;
+	int axis1 = (_axis + 1) % 3;
+	int axis2 = (_axis + 2) % 3;
+
+	_active.clear();
+	for(int k = 0; k < (int)_code.size(); k++)
+	{
+		int id = _code[k] >> 1;
+		int a = store->_slot[id];
+
+		if(_code[k] & 1)
+		{
+			// fim do intervalo: sai da lista de abertos
+			int index = _activeIndex[id];
+			int last = _active.back();
+			_active[index] = last;
+			_activeIndex[store->_id[last]] = index;
+			_active.pop_back();
+			_activeIndex[id] = -1;
+			continue;
+		}
+
+		// inicio do intervalo: pares com todos os intervalos abertos
+		const float* pa = &position[a].x;
+		bool sleeping = type[a] == Particle::SLEEPING;
+		for(int m = 0; m < (int)_active.size(); m++)
+		{
+			int b = _active[m];
+			if(sleeping && type[b] == Particle::SLEEPING)
+				continue;
+
+			const float* pb = &position[b].x;
+			float h = radius[a] + radius[b];
+			if(fabsf(pa[axis1] - pb[axis1]) > h || fabsf(pa[axis2] - pb[axis2]) > h)
+				continue;
+
+			pairs.push_back(a < b ? a : b);
+			pairs.push_back(a < b ? b : a);
+		}
+
+		_activeIndex[id] = (int)_active.size();
+		_active.push_back(a);
+	}
+
+	return (int)pairs.size() / 2;
+}
@@ -0,0 +1,58 @@
+// sweepandprune.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include <vector>
+
+class ParticleStore;
+
+// Fase larga por ordenacao e varredura (sweep and prune) em um eixo.
+// Os extremos dos intervalos das particulas no eixo (centro -/+ raio) ficam
+// em um vetor ordenado que persiste entre os passos; a cada passo os
+// valores sao atualizados e o vetor e reordenado por insercao, que custa
+// O(n + trocas). Em cenas coerentes (pilhas em repouso, pano assentado) as
+// particulas quase nao trocam de ordem e a reordenacao e praticamente
+// linear. A varredura mantem as particulas cujo intervalo esta aberto e
+// emite os pares cujas caixas tambem se sobrepoem nos outros dois eixos,
+// exceto pares de duas particulas adormecidas.
+// Os extremos guardam o identificador da particula (ver ParticleStore), e
+// nao a posicao, para sobreviver a reordenacoes e remocoes. Quando muitas
+// particulas entram de uma vez (primeiro passo, rajadas) o vetor e
+// reconstruido com uma ordenacao completa no eixo de maior dispersao.
+class SweepAndPrune
+{
+public:
+	SweepAndPrune();
+	~SweepAndPrune();
+
+	// eixo da varredura (0: x, 1: y, 2: z), escolhido na reconstrucao
+	int _axis;
+
+	// estatisticas do ultimo passo: trocas da ordenacao por insercao e
+	// reconstrucoes completas desde o inicio
+	int _swaps;
+	int _rebuilds;
+
+	// Preenche pairs com os pares candidatos (2 indices por par); retorna o
+	// numero de pares
+	int FindPairs(ParticleStore* store, std::vector<int>& pairs);
+
+private:
+	// extremos ordenados: valor e codigo (identificador << 1 | fim)
+	std::vector<float> _value;
+	std::vector<int> _code;
+	// por identificador: se ja tem extremos e a posicao na lista de abertos
+	std::vector<unsigned char> _tracked;
+	std::vector<int> _activeIndex;
+	std::vector<int> _active;
+
+	void Rebuild(ParticleStore* store);
+	void Update(ParticleStore* store);
+	void Sort();
+};
+
+#endif
@@ -0,0 +1,31 @@
+// symplecticeuler.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include "vector.h"
+#include "particlestore.h"
+#include "symplecticeuler.h"
+
+SymplecticEuler::SymplecticEuler()
+{
+	_integratorType = SYMPLECTIC_EULER;
+}
+
+inline void SymplecticEuler::Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const
+{
+	velocity.x += acceleration.x * _fixedTimeStep;
+	velocity.y += acceleration.y * _fixedTimeStep;
+	velocity.z += acceleration.z * _fixedTimeStep;
+
+	previous = position;
+
+	position.x += velocity.x * _fixedTimeStep;
+	position.y += velocity.y * _fixedTimeStep;
+	position.z += velocity.z * _fixedTimeStep;
+}
+
+void SymplecticEuler::Integrate(ParticleStore* store, int stage, int begin, int end)
+{
+	IntegrateRange(*this, store, begin, end);
+}
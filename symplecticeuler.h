@@ -0,0 +1,23 @@
+// symplecticeuler.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef SYMPLECTICEULER_H
+#define SYMPLECTICEULER_H
+
+#include "integrator.h"
+
+// Euler semi-implicito: atualiza a velocidade com a aceleracao e depois a
+// posicao com a nova velocidade. Tem o mesmo custo do Euler explicito mas
+// conserva a energia em media, o que permite passos maiores com molas.
+class SymplecticEuler : public Integrator
+{
+public:
+	SymplecticEuler();
+
+	void Integrate(ParticleStore* store, int stage, int begin, int end);
+	void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
+};
+
+#endif
@@ -0,0 +1,200 @@
+// timestepper.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <string.h>
+
+#include "profiler.h"
+#include "simulation.h"
+#include "timestepper.h"
+
+// fatores de seguranca e limites de variacao do passo entre tentativas
+static const float s_safety = 0.9f;
+static const float s_maxGrowth = 2.0f;
+static const float s_minShrink = 0.2f;
+
+TimeStepper::TimeStepper()
+{
+	_adaptive = false;
+	_tolerance = 1e-3f;
+	_minTimeStep = 1e-4f;
+	_maxTimeStep = 0.1f;
+	_maxElapsed = 0.25f;
+
+	_accumulator = 0.0f;
+	_timeStep = 0.0f;
+
+	_steps = 0;
+	_rejected = 0;
+	_error = 0.0f;
+}
+
+void TimeStepper::Save(ParticleStore* store)
+{
+	int count = store->_count;
+	_position.resize(count);
+	_previous.resize(count);
+	_velocity.resize(count);
+	_type.resize(count);
+	if(count == 0)
+		return;
+
+	memcpy((void*)&_position[0], store->_currPosition, count * sizeof(Vector3));
+	memcpy((void*)&_previous[0], store->_prevPosition, count * sizeof(Vector3));
+	memcpy((void*)&_velocity[0], store->_currVelocity, count * sizeof(Vector3));
+	// o passo pode adormecer ou acordar particulas (ver islands.h)
+	memcpy(&_type[0], store->_particleType, count * sizeof(Particle::ParticleType));
+}
+
+void TimeStepper::Restore(ParticleStore* store)
+{
+	int count = (int)_position.size();
+	store->Resize(count);
+	if(count == 0)
+		return;
+
+	memcpy(store->_currPosition, &_position[0], count * sizeof(Vector3));
+	memcpy(store->_prevPosition, &_previous[0], count * sizeof(Vector3));
+	memcpy(store->_currVelocity, &_velocity[0], count * sizeof(Vector3));
+	memcpy(store->_particleType, &_type[0], count * sizeof(Particle::ParticleType));
+}
+
+// Distancia media quadratica entre as posicoes atuais e as do passo inteiro
+float TimeStepper::Difference(ParticleStore* store)
+{
+	int count = store->_count < (int)_single.size() ? store->_count : (int)_single.size();
+	double error = 0.0;
+	int active = 0;
+	for(int i = 0; i < count; i++)
+	{
+		if(store->_particleType[i] != Particle::ACTIVE)
+			continue;
+
+		Vector3 difference = store->_currPosition[i];
+		difference -= _single[i];
+		error += difference.SqrLength();
+		active++;
+	}
+	return active > 0 ? (float)sqrt(error / active) : 0.0f;
+}
+
+float TimeStepper::Step(Simulation* simulation, float timeStep)
+{
+	PROFILE_ZONE("TimeStepper::Step", 0);
+
+	ParticleStore* store = &simulation->_store;
+	Integrator* integrator = simulation->_integrator;
+
+	// as ilhas contam tempo em repouso: sao atualizadas uma unica vez por
+	// passo aceito, e nao a cada tentativa
+	bool islands = simulation->_islands._enabled;
+	simulation->_islands._enabled = false;
+
+	// a reordenacao das particulas invalidaria o estado salvo; e feita antes
+	bool morton = simulation->_morton._enabled;
+	simulation->UpdateLocality();
+	simulation->_morton._enabled = false;
+
+	// a emissao muda o numero de particulas; e feita apos o passo aceito
+	ParticleGenerator* generator = simulation->_particleGenerator;
+	bool emission = generator != 0 && generator->_enabled;
+	if(generator != 0)
+		generator->_enabled = false;
+
+	float h = timeStep;
+	Save(store);
+	for(;;)
+	{
+		// passo inteiro
+		integrator->_fixedTimeStep = h;
+		simulation->Update();
+		_single.resize(store->_count);
+		if(store->_count > 0)
+			memcpy((void*)&_single[0], store->_currPosition, store->_count * sizeof(Vector3));
+
+		// dois meios passos a partir do mesmo estado
+		Restore(store);
+		integrator->_fixedTimeStep = 0.5f * h;
+		simulation->Update();
+		simulation->Update();
+
+		// o erro local dos integradores de primeira ordem e O(h^2)
+		_error = Difference(store);
+		float factor = _error > 0.0f ? s_safety * sqrtf(_tolerance / _error) : s_maxGrowth;
+
+		if(_error <= _tolerance || h <= _minTimeStep)
+		{
+			_steps++;
+
+			// um passo encurtado pelo acumulador nao reduz a proposta
+			if(factor > s_maxGrowth)
+				factor = s_maxGrowth;
+			float next = h * factor;
+			if(h == timeStep && h < _timeStep && factor >= 1.0f)
+				next = _timeStep;
+			if(next > _maxTimeStep)
+				next = _maxTimeStep;
+			if(next < _minTimeStep)
+				next = _minTimeStep;
+			_timeStep = next;
+
+			simulation->_islands._enabled = islands;
+			simulation->_morton._enabled = morton;
+			integrator->_fixedTimeStep = h;
+			simulation->UpdateIslands();
+			if(generator != 0)
+				generator->_enabled = emission;
+			simulation->UpdateParticleGenerator();
+			return h;
+		}
+
+		_rejected++;
+		Restore(store);
+		if(factor < s_minShrink)
+			factor = s_minShrink;
+		h *= factor;
+		if(h < _minTimeStep)
+			h = _minTimeStep;
+	}
+}
+
+int TimeStepper::Advance(Simulation* simulation, float elapsed)
+{
+	PROFILE_ZONE("TimeStepper::Advance", 0);
+
+	Integrator* integrator = simulation->_integrator;
+
+	if(elapsed > _maxElapsed)
+		elapsed = _maxElapsed;
+	_accumulator += elapsed;
+
+	int steps = 0;
+	if(!_adaptive)
+	{
+		float h = integrator->_fixedTimeStep;
+		while(_accumulator >= h)
+		{
+			simulation->Update();
+			_accumulator -= h;
+			steps++;
+		}
+		return steps;
+	}
+
+	if(_timeStep <= 0.0f)
+		_timeStep = integrator->_fixedTimeStep;
+
+	// o que sobra abaixo do menor passo fica para o proximo quadro
+	while(_accumulator >= _minTimeStep)
+	{
+		float h = _timeStep < _accumulator ? _timeStep : _accumulator;
+		_accumulator -= Step(simulation, h);
+		steps++;
+	}
+
+	// o integrador fica com o passo proposto para chamadas diretas de Update
+	integrator->_fixedTimeStep = _timeStep;
+	return steps;
+}
@@ -0,0 +1,75 @@
+// timestepper.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef TIMESTEPPER_H
+#define TIMESTEPPER_H
+
+#include <vector>
+
+#include "vector.h"
+#include "particle.h"
+
+class Simulation;
+class ParticleStore;
+
+// Controle do passo de tempo. O tempo real decorrido entre quadros e
+// acumulado e consumido em passos da simulacao, de modo que a taxa da
+// simulacao nao depende da taxa de desenho.
+// No modo fixo cada passo usa o passo do integrador. No modo adaptativo o
+// erro local de cada passo e estimado por duplicacao do passo: o estado e
+// avancado com um passo h e, a partir do mesmo estado, com dois passos h/2;
+// a diferenca media quadratica das posicoes das particulas ativas entre as
+// duas solucoes e o erro (a media evita que um unico contato, cuja resposta
+// nao depende de h, limite o passo da cena inteira). O passo e
+// aceito (com o resultado dos dois meios passos) se o erro fica abaixo de
+// _tolerance, e o proximo passo cresce; caso contrario o estado e
+// restaurado e o passo e refeito menor. Cenas calmas passam a usar passos
+// longos e poucos passos por quadro; molas ou colisoes violentas subdividem
+// o passo ate _minTimeStep.
+class TimeStepper
+{
+public:
+	TimeStepper();
+
+	bool _adaptive;
+	// erro local aceito por passo, em unidades de posicao
+	float _tolerance;
+	float _minTimeStep;
+	float _maxTimeStep;
+	// tempo real maximo consumido por chamada de Advance; o excesso e
+	// descartado para que quadros lentos nao gerem cada vez mais passos
+	float _maxElapsed;
+
+	float _accumulator;
+	// passo proposto para o proximo passo adaptativo (0: usa o do integrador)
+	float _timeStep;
+
+	// estatisticas: passos aceitos, passos rejeitados e ultimo erro estimado
+	int _steps;
+	int _rejected;
+	float _error;
+
+	// Avanca a simulacao por elapsed segundos de tempo real; retorna o numero
+	// de passos executados
+	int Advance(Simulation* simulation, float elapsed);
+
+	// Executa um passo adaptativo de no maximo timeStep; retorna o passo
+	// efetivamente usado
+	float Step(Simulation* simulation, float timeStep);
+
+private:
+	// estado salvo no inicio do passo e posicoes do passo inteiro
+	std::vector<Vector3> _position;
+	std::vector<Vector3> _previous;
+	std::vector<Vector3> _velocity;
+	std::vector<Particle::ParticleType> _type;
+	std::vector<Vector3> _single;
+
+	void Save(ParticleStore* store);
+	void Restore(ParticleStore* store);
+	float Difference(ParticleStore* store);
+};
+
+#endif
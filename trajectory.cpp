@@ -0,0 +1,764 @@
+// trajectory.cpp
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "particlestore.h"
+#include "trajectory.h"
+
+// Formato do arquivo
+//   cabecalho: "SFTR", versao, bits, intervalo entre quadros chave
+//   quadros:   grade de quantizacao de cada sequencia, bytes do conteudo,
+//              numero de particulas, quadro chave (0/1), conteudo codificado
+//   indice:    para cada quadro, posicao no arquivo e quadro chave anterior
+//   rodape:    posicao do indice, numero de quadros, "SFTI"
+// O conteudo de um quadro sao 6 sequencias de valores quantizados (x, y e z
+// das posicoes e das velocidades). Em quadros chave cada valor e codificado
+// como diferenca em relacao a particula anterior; nos demais, em relacao a
+// extrapolacao linear da mesma particula nos dois quadros anteriores (ou ao
+// quadro anterior, logo apos um quadro chave), na grade do quadro atual. As diferencas passam por zigzag e sao
+// gravadas com codigos de Rice, com o parametro escolhido a cada bloco.
+
+static const char s_headerMagic[4] = { 'S', 'F', 'T', 'R' };
+static const char s_footerMagic[4] = { 'S', 'F', 'T', 'I' };
+
+// valores por bloco de Rice
+#define RICE_BLOCK 64
+// quocientes a partir deste valor sao gravados sem compressao
+#define RICE_ESCAPE 24
+// quadros em transito entre Record e a thread de gravacao
+#define RECORDER_FRAMES 4
+
+struct FrameHeader
+{
+	long long origin[6];
+	int exponent[6];
+	int bytes;
+	int count;
+	int keyframe;
+	int padding;
+};
+
+struct IndexEntry
+{
+	unsigned long long offset;
+	int keyframe;
+	int padding;
+};
+
+struct Footer
+{
+	unsigned long long indexOffset;
+	int frameCount;
+	char magic[4];
+};
+
+static bool Seek(FILE* file, unsigned long long offset)
+{
+#ifdef _MSC_VER
+	return _fseeki64(file, (long long)offset, SEEK_SET) == 0;
+#else
+	return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static unsigned int ZigZag(int value)
+{
+	return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int UnZigZag(unsigned int value)
+{
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+//
+// Codigos de Rice
+//
+
+struct BitWriter
+{
+	std::vector<unsigned char>* _out;
+	unsigned long long _bits;
+	int _count;
+
+	BitWriter(std::vector<unsigned char>* out)
+	{
+		_out = out;
+		_bits = 0;
+		_count = 0;
+	}
+
+	// count <= 32
+	void Put(unsigned int value, int count)
+	{
+		_bits |= (unsigned long long)value << _count;
+		_count += count;
+		while(_count >= 8)
+		{
+			_out->push_back((unsigned char)_bits);
+			_bits >>= 8;
+			_count -= 8;
+		}
+	}
+
+	void Flush()
+	{
+		if(_count > 0)
+			_out->push_back((unsigned char)_bits);
+		_bits = 0;
+		_count = 0;
+	}
+};
+
+struct BitReader
+{
+	const unsigned char* _data;
+	size_t _size;
+	size_t _offset;
+	unsigned long long _bits;
+	int _count;
+	bool _failed;
+
+	BitReader(const unsigned char* data, size_t size)
+	{
+		_data = data;
+		_size = size;
+		_offset = 0;
+		_bits = 0;
+		_count = 0;
+		_failed = false;
+	}
+
+	// count <= 32
+	unsigned int Get(int count)
+	{
+		while(_count < count)
+		{
+			if(_offset == _size)
+			{
+				_failed = true;
+				return 0;
+			}
+			_bits |= (unsigned long long)_data[_offset++] << _count;
+			_count += 8;
+		}
+		unsigned int value = (unsigned int)(_bits & ((1ULL << count) - 1));
+		_bits >>= count;
+		_count -= count;
+		return value;
+	}
+};
+
+static void RiceEncode(const unsigned int* values, int count, BitWriter& writer)
+{
+	for(int begin = 0; begin < count; begin += RICE_BLOCK)
+	{
+		int end = begin + RICE_BLOCK < count ? begin + RICE_BLOCK : count;
+
+		// parametro proximo do log2 da media do bloco
+		unsigned long long sum = 0;
+		for(int i = begin; i < end; i++)
+		{
+			sum += values[i];
+		}
+		int k = 0;
+		while(k < 31 && ((unsigned long long)(end - begin) << (k + 1)) <= sum)
+			k++;
+		writer.Put(k, 5);
+
+		for(int i = begin; i < end; i++)
+		{
+			unsigned int q = values[i] >> k;
+			if(q < RICE_ESCAPE)
+			{
+				writer.Put((1u << q) - 1, q + 1);
+				if(k > 0)
+					writer.Put(values[i] & ((1u << k) - 1), k);
+			}
+			else
+			{
+				writer.Put((1u << RICE_ESCAPE) - 1, RICE_ESCAPE);
+				writer.Put(values[i], 32);
+			}
+		}
+	}
+}
+
+static bool RiceDecode(unsigned int* values, int count, BitReader& reader)
+{
+	for(int begin = 0; begin < count; begin += RICE_BLOCK)
+	{
+		int end = begin + RICE_BLOCK < count ? begin + RICE_BLOCK : count;
+		int k = reader.Get(5);
+
+		for(int i = begin; i < end; i++)
+		{
+			unsigned int q = 0;
+			while(q < RICE_ESCAPE && reader.Get(1) != 0)
+				q++;
+
+			if(q < RICE_ESCAPE)
+				values[i] = k > 0 ? (q << k) | reader.Get(k) : q;
+			else
+				values[i] = reader.Get(32);
+		}
+		if(reader._failed)
+			return false;
+	}
+	return true;
+}
+
+//
+// Quantizacao
+//
+
+// O valor quantizado q de uma sequencia representa (origin + q) * 2^exponent.
+// O passo e uma potencia de 2 e a origem e multiplo do passo, entao valores
+// de quadros com grades diferentes sao comparados com aritmetica inteira.
+static void ComputeGrid(const Vector3* values, int count, int c, int bits, long long& origin, int& exponent)
+{
+	float min = FLT_MAX;
+	float max = -FLT_MAX;
+
+	for(int i = 0; i < count; i++)
+	{
+		float v = (&values[i].x)[c];
+		if(v - v == 0.0f)
+		{
+			if(v < min)
+				min = v;
+			if(v > max)
+				max = v;
+		}
+	}
+	if(min > max)
+		min = max = 0.0f;
+
+	// a extensao minima limita a origem a cerca de 2^(20 + bits) passos
+	double magnitude = fabs(min) > fabs(max) ? fabs(min) : fabs(max);
+	double extent = (double)max - (double)min;
+	if(extent < ldexp(magnitude, -20))
+		extent = ldexp(magnitude, -20);
+	if(extent < 1.0e-30)
+		extent = 1.0e-30;
+
+	// menor potencia de 2 com (2^bits - 2) passos cobrindo a extensao
+	frexp(extent / ((1u << bits) - 2), &exponent);
+	origin = (long long)floor(ldexp((double)min, -exponent));
+}
+
+static void Quantize(const Vector3* values, int count, int c, int bits, long long origin, int exponent, unsigned int* out)
+{
+	double levels = (double)((1u << bits) - 1);
+
+	for(int i = 0; i < count; i++)
+	{
+		double q = floor(ldexp((double)(&values[i].x)[c], -exponent) + 0.5) - (double)origin;
+		if(!(q >= 0.0))
+			q = 0.0;
+		if(q > levels)
+			q = levels;
+		out[i] = (unsigned int)q;
+	}
+}
+
+static void Dequantize(const unsigned int* q, int count, int c, long long origin, int exponent, Vector3* values)
+{
+	for(int i = 0; i < count; i++)
+	{
+		(&values[i].x)[c] = (float)ldexp((double)(origin + q[i]), exponent);
+	}
+}
+
+// valor quantizado de outro quadro convertido para a grade (origin, exponent)
+static long long Convert(unsigned int q, long long fromOrigin, int fromExponent, long long origin, int exponent)
+{
+	// o valor e negativo quando a origem e: deslocamentos de negativos sao
+	// indefinidos (<<) ou dependem da implementacao (>>), entao a escala e
+	// feita por multiplicacao e divisao arredondada para baixo
+	long long value = fromOrigin + q;
+	if(fromExponent >= exponent)
+		value *= 1LL << (fromExponent - exponent);
+	else
+	{
+		long long divisor = 1LL << (exponent - fromExponent);
+		value = value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+	}
+	return value - origin;
+}
+
+// Predicao de uma sequencia na grade do quadro atual: extrapolacao linear
+// dos dois quadros anteriores ou, sem previous2, o proprio quadro anterior.
+static void Predict(int count, unsigned int levels, long long origin, int exponent,
+	const unsigned int* previous, long long previousOrigin, int previousExponent,
+	const unsigned int* previous2, long long previous2Origin, int previous2Exponent,
+	unsigned int* prediction)
+{
+	for(int i = 0; i < count; i++)
+	{
+		long long value = Convert(previous[i], previousOrigin, previousExponent, origin, exponent);
+		if(previous2 != 0)
+			value = 2 * value - Convert(previous2[i], previous2Origin, previous2Exponent, origin, exponent);
+
+		if(value < 0)
+			value = 0;
+		if(value > levels)
+			value = levels;
+		prediction[i] = (unsigned int)value;
+	}
+}
+
+//
+// TrajectoryRecorder
+//
+
+TrajectoryRecorder::TrajectoryRecorder()
+{
+	_frameCount = 0;
+	_file = 0;
+	_bits = 16;
+	_keyframeInterval = 64;
+	_failed = false;
+	_offset = 0;
+	_previousCount = -1;
+	_lastKeyframe = 0;
+	_closing = false;
+
+	memset(_previousOrigin, 0, sizeof(_previousOrigin));
+	memset(_previousExponent, 0, sizeof(_previousExponent));
+	memset(_previous2Origin, 0, sizeof(_previous2Origin));
+	memset(_previous2Exponent, 0, sizeof(_previous2Exponent));
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+	Close();
+}
+
+bool TrajectoryRecorder::Open(const char* path, int bits, int keyframeInterval)
+{
+	Close();
+
+	_file = fopen(path, "wb");
+	if(_file == 0)
+		return false;
+
+	_bits = bits < 2 ? 2 : (bits > 24 ? 24 : bits);
+	_keyframeInterval = keyframeInterval < 1 ? 1 : keyframeInterval;
+	_failed = false;
+	_frameCount = 0;
+	_offset = 0;
+	_index.clear();
+	_keyframes.clear();
+	_previousCount = -1;
+	_lastKeyframe = 0;
+	_closing = false;
+
+	int header[3] = { TRAJECTORY_VERSION, _bits, _keyframeInterval };
+	Write(s_headerMagic, sizeof(s_headerMagic));
+	Write(header, sizeof(header));
+
+	for(int i = 0; i < RECORDER_FRAMES; i++)
+	{
+		_pool.push_back(new Frame());
+	}
+	_thread = std::thread(&TrajectoryRecorder::WriterLoop, this);
+
+	return !_failed;
+}
+
+void TrajectoryRecorder::Record(ParticleStore* store)
+{
+	if(_file == 0)
+		return;
+
+	// espera um quadro livre se a gravacao estiver atrasada
+	Frame* frame;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		while(_pool.empty())
+			_free.wait(lock);
+		frame = _pool.back();
+		_pool.pop_back();
+	}
+
+	// na ordem dos identificadores, que nao muda quando as particulas sao
+	// reordenadas no armazenamento; identificadores livres ficam zerados
+	int count = (int)store->_slot.size();
+	frame->_count = count;
+	frame->_position.assign(count, Vector3(0.0f, 0.0f, 0.0f));
+	frame->_velocity.assign(count, Vector3(0.0f, 0.0f, 0.0f));
+	for(int i = 0; i < store->_count; i++)
+	{
+		int id = store->_id[i];
+		frame->_position[id] = store->_currPosition[i];
+		frame->_velocity[id] = store->_currVelocity[i];
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_queue.push_back(frame);
+	}
+	_ready.notify_one();
+
+	_frameCount++;
+}
+
+bool TrajectoryRecorder::Close()
+{
+	if(_file == 0)
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_closing = true;
+	}
+	_ready.notify_one();
+	_thread.join();
+
+	for(int i = 0; i < (int)_pool.size(); i++)
+	{
+		delete _pool[i];
+	}
+	_pool.clear();
+
+	// indice e rodape
+	Footer footer;
+	footer.indexOffset = _offset;
+	footer.frameCount = (int)_index.size();
+	memcpy(footer.magic, s_footerMagic, sizeof(s_footerMagic));
+
+	for(int i = 0; i < (int)_index.size(); i++)
+	{
+		IndexEntry entry;
+		entry.offset = _index[i];
+		entry.keyframe = _keyframes[i];
+		entry.padding = 0;
+		Write(&entry, sizeof(entry));
+	}
+	Write(&footer, sizeof(footer));
+
+	bool ok = !_failed;
+	if(fclose(_file) != 0)
+		ok = false;
+	_file = 0;
+
+	return ok;
+}
+
+void TrajectoryRecorder::WriterLoop()
+{
+	for(;;)
+	{
+		Frame* frame;
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			while(_queue.empty() && !_closing)
+				_ready.wait(lock);
+			if(_queue.empty())
+				return;
+			frame = _queue.front();
+			_queue.pop_front();
+		}
+
+		Encode(frame);
+
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_pool.push_back(frame);
+		}
+		_free.notify_one();
+	}
+}
+
+void TrajectoryRecorder::Encode(Frame* frame)
+{
+	int count = frame->_count;
+	int frameNumber = (int)_index.size();
+	unsigned int levels = (1u << _bits) - 1;
+
+	// 6 sequencias: x, y, z das posicoes e depois das velocidades
+	FrameHeader header;
+	header.padding = 0;
+	for(int s = 0; s < 6; s++)
+	{
+		const Vector3* values = count > 0 ? (s < 3 ? &frame->_position[0] : &frame->_velocity[0]) : 0;
+		ComputeGrid(values, count, s % 3, _bits, header.origin[s], header.exponent[s]);
+	}
+
+	// grades muito diferentes das anteriores tornam a predicao inutil
+	int order = frameNumber - _lastKeyframe >= 2 ? 2 : 1;
+	bool keyframe = count != _previousCount || frameNumber - _lastKeyframe >= _keyframeInterval;
+	for(int s = 0; s < 6 && !keyframe; s++)
+	{
+		if(abs(header.exponent[s] - _previousExponent[s]) > 16 ||
+			(order == 2 && abs(header.exponent[s] - _previous2Exponent[s]) > 16))
+			keyframe = true;
+	}
+	if(keyframe)
+		_lastKeyframe = frameNumber;
+
+	header.count = count;
+	header.keyframe = keyframe;
+
+	_quantized.resize(6 * count);
+	_prediction.resize(6 * count);
+	_residual.resize(6 * count);
+	for(int s = 0; s < 6 && count > 0; s++)
+	{
+		const Vector3* values = s < 3 ? &frame->_position[0] : &frame->_velocity[0];
+		unsigned int* q = &_quantized[s * count];
+		unsigned int* p = &_prediction[s * count];
+		unsigned int* r = &_residual[s * count];
+
+		Quantize(values, count, s % 3, _bits, header.origin[s], header.exponent[s], q);
+
+		// o quadro chave usa a particula anterior como predicao
+		if(keyframe)
+		{
+			p[0] = 0;
+			for(int i = 1; i < count; i++)
+			{
+				p[i] = q[i-1];
+			}
+		}
+		else
+		{
+			Predict(count, levels, header.origin[s], header.exponent[s],
+				&_previous[s * count], _previousOrigin[s], _previousExponent[s],
+				order == 2 ? &_previous2[s * count] : 0, _previous2Origin[s], _previous2Exponent[s],
+				p);
+		}
+
+		for(int i = 0; i < count; i++)
+		{
+			r[i] = ZigZag((int)(q[i] - p[i]));
+		}
+	}
+
+	_encoded.clear();
+	BitWriter writer(&_encoded);
+	if(count > 0)
+		RiceEncode(&_residual[0], 6 * count, writer);
+	writer.Flush();
+
+	header.bytes = (int)_encoded.size();
+
+	_index.push_back(_offset);
+	_keyframes.push_back(_lastKeyframe);
+	Write(&header, sizeof(header));
+	if(!_encoded.empty())
+		Write(&_encoded[0], _encoded.size());
+
+	_previous2.swap(_previous);
+	_previous.swap(_quantized);
+	memcpy(_previous2Origin, _previousOrigin, sizeof(_previousOrigin));
+	memcpy(_previous2Exponent, _previousExponent, sizeof(_previousExponent));
+	memcpy(_previousOrigin, header.origin, sizeof(_previousOrigin));
+	memcpy(_previousExponent, header.exponent, sizeof(_previousExponent));
+	_previousCount = count;
+}
+
+void TrajectoryRecorder::Write(const void* data, size_t bytes)
+{
+	if(fwrite(data, 1, bytes, _file) != bytes)
+		_failed = true;
+	_offset += bytes;
+}
+
+//
+// TrajectoryPlayer
+//
+
+TrajectoryPlayer::TrajectoryPlayer()
+{
+	_frameCount = 0;
+	_file = 0;
+	_bits = 16;
+	_current = -1;
+	_currentCount = 0;
+
+	memset(_origin, 0, sizeof(_origin));
+	memset(_exponent, 0, sizeof(_exponent));
+	memset(_previousOrigin, 0, sizeof(_previousOrigin));
+	memset(_previousExponent, 0, sizeof(_previousExponent));
+}
+
+TrajectoryPlayer::~TrajectoryPlayer()
+{
+	Close();
+}
+
+bool TrajectoryPlayer::Open(const char* path)
+{
+	Close();
+
+	_file = fopen(path, "rb");
+	if(_file == 0)
+		return false;
+
+	char magic[4];
+	int header[3];
+	Footer footer;
+
+	bool ok = fread(magic, 1, sizeof(magic), _file) == sizeof(magic) &&
+		memcmp(magic, s_headerMagic, sizeof(magic)) == 0 &&
+		fread(header, 1, sizeof(header), _file) == sizeof(header) &&
+		header[0] == TRAJECTORY_VERSION && header[1] >= 2 && header[1] <= 24 &&
+		fseek(_file, -(long)sizeof(footer), SEEK_END) == 0 &&
+		fread(&footer, 1, sizeof(footer), _file) == sizeof(footer) &&
+		memcmp(footer.magic, s_footerMagic, sizeof(magic)) == 0 &&
+		footer.frameCount >= 0 &&
+		Seek(_file, footer.indexOffset);
+
+	if(ok)
+	{
+		_bits = header[1];
+		_frameCount = footer.frameCount;
+		_index.resize(_frameCount);
+		_keyframes.resize(_frameCount);
+
+		for(int i = 0; i < _frameCount && ok; i++)
+		{
+			IndexEntry entry;
+			ok = fread(&entry, 1, sizeof(entry), _file) == sizeof(entry) &&
+				entry.keyframe >= 0 && entry.keyframe <= i;
+			_index[i] = entry.offset;
+			_keyframes[i] = entry.keyframe;
+		}
+	}
+
+	if(!ok)
+		Close();
+	return ok;
+}
+
+void TrajectoryPlayer::Close()
+{
+	if(_file != 0)
+		fclose(_file);
+	_file = 0;
+	_frameCount = 0;
+	_index.clear();
+	_keyframes.clear();
+	_current = -1;
+	_currentCount = 0;
+}
+
+int TrajectoryPlayer::ParticleCount(int frame)
+{
+	if(_file == 0 || frame < 0 || frame >= _frameCount)
+		return -1;
+	if(frame == _current)
+		return _currentCount;
+
+	FrameHeader header;
+	if(!Seek(_file, _index[frame]) || fread(&header, 1, sizeof(header), _file) != sizeof(header))
+		return -1;
+	return header.count;
+}
+
+bool TrajectoryPlayer::Decode(int frame)
+{
+	FrameHeader header;
+	if(!Seek(_file, _index[frame]) || fread(&header, 1, sizeof(header), _file) != sizeof(header))
+		return false;
+	if(header.count < 0 || header.bytes < 0)
+		return false;
+	if(!header.keyframe && header.count != _currentCount)
+		return false;
+
+	_encoded.resize(header.bytes);
+	if(header.bytes > 0 && fread(&_encoded[0], 1, header.bytes, _file) != (size_t)header.bytes)
+		return false;
+
+	int count = header.count;
+	_residual.resize(6 * count);
+	BitReader reader(header.bytes > 0 ? &_encoded[0] : 0, header.bytes);
+	if(count > 0 && !RiceDecode(&_residual[0], 6 * count, reader))
+		return false;
+
+	unsigned int levels = (1u << _bits) - 1;
+	int order = frame - _keyframes[frame] >= 2 ? 2 : 1;
+
+	_prediction.resize(6 * count);
+	for(int s = 0; s < 6 && count > 0; s++)
+	{
+		unsigned int* q = &_prediction[s * count];
+		const unsigned int* r = &_residual[s * count];
+
+		if(header.keyframe)
+		{
+			unsigned int last = 0;
+			for(int i = 0; i < count; i++)
+			{
+				q[i] = last + UnZigZag(r[i]);
+				last = q[i];
+			}
+		}
+		else
+		{
+			// o gravador nunca prediz entre grades com expoentes a mais de
+			// 16 de distancia; Convert conta com esse limite
+			if(abs(header.exponent[s] - _exponent[s]) > 16 ||
+				(order == 2 && abs(header.exponent[s] - _previousExponent[s]) > 16))
+				return false;
+
+			Predict(count, levels, header.origin[s], header.exponent[s],
+				&_quantized[s * count], _origin[s], _exponent[s],
+				order == 2 ? &_previous[s * count] : 0, _previousOrigin[s], _previousExponent[s],
+				q);
+			for(int i = 0; i < count; i++)
+			{
+				q[i] += UnZigZag(r[i]);
+			}
+		}
+	}
+
+	// o quadro atual passa a ser o anterior
+	_previous.swap(_quantized);
+	_quantized.swap(_prediction);
+	memcpy(_previousOrigin, _origin, sizeof(_origin));
+	memcpy(_previousExponent, _exponent, sizeof(_exponent));
+	memcpy(_origin, header.origin, sizeof(_origin));
+	memcpy(_exponent, header.exponent, sizeof(_exponent));
+	_current = frame;
+	_currentCount = count;
+	return true;
+}
+
+bool TrajectoryPlayer::ReadFrame(int frame, Vector3* position, Vector3* velocity)
+{
+	if(_file == 0 || frame < 0 || frame >= _frameCount)
+		return false;
+
+	// continua do quadro atual quando ele esta entre o quadro chave e o pedido
+	int first = _keyframes[frame];
+	if(_current >= first && _current <= frame)
+		first = _current + 1;
+
+	for(int f = first; f <= frame; f++)
+	{
+		if(!Decode(f))
+		{
+			_current = -1;
+			return false;
+		}
+	}
+
+	int count = _currentCount;
+	if(count > 0)
+	{
+		for(int s = 0; s < 6; s++)
+		{
+			Dequantize(&_quantized[s * count], count, s % 3, _origin[s], _exponent[s], s < 3 ? position : velocity);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,147 @@
+// trajectory.h
+// Simulao Fsica para Jogos
+// L. Camello - camello@tecgraf.puc-rio.br
+// PUC-Rio, Out 2026
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stdio.h>
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include "vector.h"
+
+class ParticleStore;
+
+#define TRAJECTORY_VERSION 1
+
+// Gravacao das trajetorias (posicao e velocidade de todas as particulas a
+// cada passo) em um arquivo compacto. As particulas sao gravadas na ordem
+// dos identificadores do ParticleStore; identificadores de particulas
+// removidas sao gravados com posicao e velocidade nulas.
+// Cada componente de cada quadro e quantizado em relacao a sua caixa
+// envolvente, com um passo potencia de 2, codificado como diferenca em
+// relacao a extrapolacao dos quadros anteriores e comprimido com codigos de
+// Rice adaptativos por bloco.
+// A cada _keyframeInterval quadros, ou quando o numero de particulas muda, o
+// quadro e gravado sem diferenca (quadro chave). O arquivo termina com um
+// indice dos quadros, de modo que a leitura de um quadro qualquer decodifica
+// apenas a partir do quadro chave anterior.
+//
+// Record apenas copia o estado para um quadro livre; a quantizacao, a
+// codificacao e a escrita no disco sao feitas por uma thread propria.
+class TrajectoryRecorder
+{
+public:
+	TrajectoryRecorder();
+	~TrajectoryRecorder();
+
+	// bits: resolucao da quantizacao por componente (2 a 24)
+	// keyframeInterval: quadros entre quadros chave
+	bool Open(const char* path, int bits = 16, int keyframeInterval = 64);
+	void Record(ParticleStore* store);
+	// Espera a gravacao dos quadros pendentes e grava o indice
+	bool Close();
+
+	int _frameCount;
+
+private:
+	struct Frame
+	{
+		int _count;
+		std::vector<Vector3> _position;
+		std::vector<Vector3> _velocity;
+	};
+
+	FILE* _file;
+	int _bits;
+	int _keyframeInterval;
+	bool _failed;
+
+	// estado do codificador, usado apenas pela thread de gravacao
+	unsigned long long _offset;
+	std::vector<unsigned long long> _index;
+	std::vector<int> _keyframes;
+	std::vector<unsigned int> _quantized;
+	std::vector<unsigned int> _prediction;
+	std::vector<unsigned int> _residual;
+	std::vector<unsigned char> _encoded;
+
+	// os dois quadros anteriores, quantizados, e suas grades
+	std::vector<unsigned int> _previous;
+	std::vector<unsigned int> _previous2;
+	long long _previousOrigin[6];
+	int _previousExponent[6];
+	long long _previous2Origin[6];
+	int _previous2Exponent[6];
+	int _previousCount;
+	int _lastKeyframe;
+
+	// fila de quadros entre Record e a thread de gravacao
+	std::thread _thread;
+	std::mutex _lock;
+	std::condition_variable _ready;
+	std::condition_variable _free;
+	std::deque<Frame*> _queue;
+	std::vector<Frame*> _pool;
+	bool _closing;
+
+	void WriterLoop();
+	void Encode(Frame* frame);
+	void Write(const void* data, size_t bytes);
+
+	TrajectoryRecorder(const TrajectoryRecorder&);
+	TrajectoryRecorder& operator= (const TrajectoryRecorder&);
+};
+
+// Leitura de arquivos gravados por TrajectoryRecorder com acesso direto a
+// qualquer quadro.
+class TrajectoryPlayer
+{
+public:
+	TrajectoryPlayer();
+	~TrajectoryPlayer();
+
+	int _frameCount;
+
+	bool Open(const char* path);
+	void Close();
+
+	// Numero de particulas do quadro, ou -1 se o quadro nao existe
+	int ParticleCount(int frame);
+
+	// Decodifica o quadro; position e velocity devem ter ParticleCount(frame)
+	// elementos. Quadros lidos em sequencia decodificam apenas a diferenca.
+	bool ReadFrame(int frame, Vector3* position, Vector3* velocity);
+
+private:
+	FILE* _file;
+	int _bits;
+	std::vector<unsigned long long> _index;
+	std::vector<int> _keyframes;
+
+	// ultimo quadro decodificado e o anterior a ele, quantizados, e suas grades
+	int _current;
+	int _currentCount;
+	std::vector<unsigned int> _quantized;
+	std::vector<unsigned int> _previous;
+	long long _origin[6];
+	int _exponent[6];
+	long long _previousOrigin[6];
+	int _previousExponent[6];
+
+	std::vector<unsigned int> _prediction;
+	std::vector<unsigned int> _residual;
+	std::vector<unsigned char> _encoded;
+
+	bool Decode(int frame);
+
+	TrajectoryPlayer(const TrajectoryPlayer&);
+	TrajectoryPlayer& operator= (const TrajectoryPlayer&);
+};
+
+#endif
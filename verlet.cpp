@@ -4,32 +4,41 @@
 // PUC-Rio, Set 2009
 
 #include "vector.h"
-#include "particle.h"
+#include "particlestore.h"
 #include "verlet.h"
 
 Verlet::Verlet()
 {
+	_integratorType = VERLET;
 	_drag = 0.01f;
 }
 
-void Verlet::Integrate(Vector3 acceleration, Particle* particle)
+Verlet::~Verlet()
+{
+}
+
+inline void Verlet::Step(int index, Vector3& currPosition, Vector3& prevPosition, Vector3& velocity, const Vector3& acceleration) const
 {
 	Vector3 position;
 
-	position.x = (2 - _drag) * particle->_currPosition.x;
-	position.y = (2 - _drag) * particle->_currPosition.y;
-	position.z = (2 - _drag) * particle->_currPosition.z;
+	position.x = (2 - _drag) * currPosition.x;
+	position.y = (2 - _drag) * currPosition.y;
+	position.z = (2 - _drag) * currPosition.z;
 
-	position.x -= (1 - _drag) * particle->_prevPosition.x;
-	position.y -= (1 - _drag) * particle->_prevPosition.y;
-	position.z -= (1 - _drag) * particle->_prevPosition.z;
+	position.x -= (1 - _drag) * prevPosition.x;
+	position.y -= (1 - _drag) * prevPosition.y;
+	position.z -= (1 - _drag) * prevPosition.z;
 	
-	acceleration.x *= _fixedTimeStep * _fixedTimeStep;
-	acceleration.y *= _fixedTimeStep * _fixedTimeStep;
-	acceleration.z *= _fixedTimeStep * _fixedTimeStep;
-
-	position += acceleration;
+	float dt2 = _fixedTimeStep * _fixedTimeStep;
+	position.x += acceleration.x * dt2;
+	position.y += acceleration.y * dt2;
+	position.z += acceleration.z * dt2;
 	
-	particle->_prevPosition = particle->_currPosition;
-	particle->_currPosition = position;
+	prevPosition = currPosition;
+	currPosition = position;
+}
+
+void Verlet::Integrate(ParticleStore* store, int stage, int begin, int end)
+{
+	IntegrateRange(*this, store, begin, end);
 }
\ No newline at end of file
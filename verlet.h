@@ -8,9 +8,7 @@
 
 #include "integrator.h"
 
-struct Vector3;
-
-class Verlet : Integrator
+class Verlet : public Integrator
 {
 public:
 	Verlet();
@@ -18,7 +16,8 @@ public:
 
 	float _drag;
 	
-    void Integrate(Vector3 acceleration, Particle* particle);
+	void Integrate(ParticleStore* store, int stage, int begin, int end);
+	void Step(int index, Vector3& position, Vector3& previous, Vector3& velocity, const Vector3& acceleration) const;
 };
 
 #endif
\ No newline at end of file